@@ -1,15 +1,20 @@
 #ifndef GLAD_H
 #define GLAD_H
 
+#include <stddef.h>
+
+#ifdef _WIN32
 // Prevenir que Windows incluya gl.h
 #define WIN32_LEAN_AND_MEAN
 #define NOMINMAX
 #define NOGDI
 
 #include <windows.h>
-#include <stddef.h>
 
 #define APIENTRY __stdcall
+#elif !defined(APIENTRY)
+#define APIENTRY
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -124,6 +129,8 @@ typedef void (APIENTRY* PFNGLDELETERENDERBUFFERSPROC)(int n, const unsigned int*
 typedef void (APIENTRY* PFNGLDELETEVERTEXARRAYSPROC)(int n, const unsigned int* arrays);
 typedef void (APIENTRY* PFNGLDELETEBUFFERSPROC)(int n, const unsigned int* buffers);
 typedef void (APIENTRY* PFNGLBLITFRAMEBUFFERPROC)(int srcX0, int srcY0, int srcX1, int srcY1, int dstX0, int dstY0, int dstX1, int dstY1, unsigned int mask, unsigned int filter);
+typedef void (APIENTRY* PFNGLRENDERBUFFERSTORAGEMULTISAMPLEPROC)(unsigned int target, int samples, unsigned int internalformat, int width, int height);
+typedef void (APIENTRY* PFNGLBUFFERSUBDATAPROC)(unsigned int target, ptrdiff_t offset, ptrdiff_t size, const void* data);
 
 // OpenGL constants
 #define GL_FALSE 0
@@ -148,6 +155,7 @@ typedef void (APIENTRY* PFNGLBLITFRAMEBUFFERPROC)(int srcX0, int srcY0, int srcX
 #define GL_ARRAY_BUFFER 0x8892
 #define GL_ELEMENT_ARRAY_BUFFER 0x8893
 #define GL_STATIC_DRAW 0x88E4
+#define GL_DYNAMIC_DRAW 0x88E8
 #define GL_FRAGMENT_SHADER 0x8B30
 #define GL_VERTEX_SHADER 0x8B31
 #define GL_COMPILE_STATUS 0x8B81
@@ -161,6 +169,18 @@ typedef void (APIENTRY* PFNGLBLITFRAMEBUFFERPROC)(int srcX0, int srcY0, int srcX
 #define GL_FRAMEBUFFER_COMPLETE 0x8CD5
 #define GL_READ_FRAMEBUFFER 0x8CA8
 #define GL_DRAW_FRAMEBUFFER 0x8CA9
+#define GL_SCISSOR_TEST 0x0C11
+#define GL_PACK_ALIGNMENT 0x0D05
+#define GL_MAX_TEXTURE_SIZE 0x0D33
+#define GL_MAX_VIEWPORT_DIMS 0x0D3A
+#define GL_MAX_RENDERBUFFER_SIZE 0x84E8
+#define GL_RGBA8 0x8058
+#define GL_MAX_SAMPLES 0x8D57
+#define GL_VIEWPORT 0x0BA2
+#define GL_FRAMEBUFFER_BINDING 0x8CA6
+#define GL_TEXTURE_WRAP_S 0x2802
+#define GL_TEXTURE_WRAP_T 0x2803
+#define GL_CLAMP_TO_EDGE 0x812F
 
 // Evitar conflictos con gl.h
 #ifndef GLAD_NO_PROTOTYPES
@@ -278,6 +298,8 @@ GLAPI PFNGLDELETERENDERBUFFERSPROC glad_glDeleteRenderbuffers;
 GLAPI PFNGLDELETEVERTEXARRAYSPROC glad_glDeleteVertexArrays;
 GLAPI PFNGLDELETEBUFFERSPROC glad_glDeleteBuffers;
 GLAPI PFNGLBLITFRAMEBUFFERPROC glad_glBlitFramebuffer;
+GLAPI PFNGLRENDERBUFFERSTORAGEMULTISAMPLEPROC glad_glRenderbufferStorageMultisample;
+GLAPI PFNGLBUFFERSUBDATAPROC glad_glBufferSubData;
 
 // Convenience macros to wrap function calls
 #define glCullFace glad_glCullFace
@@ -383,6 +405,8 @@ GLAPI PFNGLBLITFRAMEBUFFERPROC glad_glBlitFramebuffer;
 #define glDeleteVertexArrays glad_glDeleteVertexArrays
 #define glDeleteBuffers glad_glDeleteBuffers
 #define glBlitFramebuffer glad_glBlitFramebuffer
+#define glRenderbufferStorageMultisample glad_glRenderbufferStorageMultisample
+#define glBufferSubData glad_glBufferSubData
 
 #ifdef __cplusplus
 }
@@ -2,21 +2,69 @@
 #include "renderer.h"
 #include "stl_loader.h"
 #include "gui.h"
+#include "process_batch.h"
+#include "render_manifest.h"
+#include "folder_watcher.h"
+#include "render_server.h"
+#include "job_stream.h"
+#include "glfw_context.h"
 
 #include <iostream>
 #include <filesystem>
-#include <windows.h>
 #include <GLFW/glfw3.h>
 #include <fstream>
 #include <ctime>
 #include <chrono>
 #include <iomanip>
 #include <sstream>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <cstdlib>
+#include <csignal>
+
+#ifdef _WIN32
+#include <windows.h>
 #include <shellapi.h>
+#endif
 
 namespace fs = std::filesystem;
 
+// Espera máxima en reposo del bucle interactivo (segundos)
+static const double kIdleWaitSeconds = 0.25;
+
+// Tiempo por frame dedicado a subir a la GPU un modelo cargado en segundo plano
+static const double kUploadBudgetMs = 8.0;
+
+// Refresco del progreso mientras la cola de renders trabaja (segundos)
+static const double kJobRefreshSeconds = 0.1;
+
+// --watch: espera máxima por vuelta y cada cuánto se guardan los manifiestos
+static const int kWatchPollMs = 500;
+static const double kWatchManifestSaveSeconds = 30.0;
+
+// Ctrl+C o SIGTERM terminan la vigilancia o el servidor después del trabajo en curso
+static std::atomic<bool> g_stopRequested(false);
+
+static void requestStop(int) {
+    g_stopRequested = true;
+}
+
+// localtime no es reentrante; cada plataforma tiene su variante segura
+static std::tm localTime(std::time_t time) {
+    std::tm tm = {};
+#ifdef _WIN32
+    localtime_s(&tm, &time);
+#else
+    localtime_r(&time, &tm);
+#endif
+    return tm;
+}
+
 App::App(bool silentMode) : m_silentMode(silentMode) {
+    // La biblioteca stlrender no enlaza GLFW: la ventana (visible u oculta) la aporta el ejecutable
+    HeadlessContext::setWindowFactory(GlfwContext::create);
+    
     // Cargar configuración
     loadConfig();
     
@@ -34,8 +82,10 @@ App::App(bool silentMode) : m_silentMode(silentMode) {
 }
 
 App::~App() {
-    // Guardar configuración antes de cerrar
-    saveConfig();
+    // Guardar configuración antes de cerrar (los procesos de trabajo comparten la del padre)
+    if (!m_workerProcess) {
+        saveConfig();
+    }
     
     // Limpiar recursos
     cleanup();
@@ -46,9 +96,15 @@ bool App::init() {
     
     // Crear e inicializar el renderer
     m_renderer = std::make_unique<Renderer>();
+    m_renderer->setBackend(m_config.renderBackend == "software" ? RenderBackend::Software : RenderBackend::OpenGL);
+    m_renderer->setHeadlessProvider(parseHeadlessProvider(m_config.headlessContext));
+    m_renderer->setOutputSamples(m_config.outputSamples);
     
     // Inicializar el loader de STL
     m_stlLoader = std::make_unique<StlLoader>();
+    m_asyncLoader = std::make_unique<AsyncModelLoader>();
+    m_jobQueue = std::make_unique<RenderJobQueue>();
+    m_jobQueue->setBackend(m_renderer->getBackend(), parseHeadlessProvider(m_config.headlessContext));
     
     // Aplicar configuración
     if (m_renderer) {
@@ -77,6 +133,13 @@ void App::cleanup() {
 }
 
 int App::run(int argc, char* argv[]) {
+    // --jsonl: stdout queda solo para los resultados; los mensajes pasan a stderr
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--jsonl" && !m_resultsOutput) {
+            m_resultsOutput = std::cout.rdbuf(std::cerr.rdbuf());
+        }
+    }
+    
     // Inicializar configuración
     loadConfig();
     
@@ -90,6 +153,67 @@ int App::run(int argc, char* argv[]) {
         return runInteractive();
     }
     
+    // Opciones con valor; el resto son archivos o carpetas. El lote por procesos se
+    // decide antes de crear el contexto: el padre no renderiza
+    int jobs = 1;
+    std::string workerList;
+    std::string journalPath;
+    std::string outputRoot;
+    std::string serveAddress;
+    std::vector<std::string> inputs;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--jobs" && i + 1 < argc) {
+            jobs = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--worker-list" && i + 1 < argc) {
+            workerList = argv[++i];
+        } else if (arg == "--journal" && i + 1 < argc) {
+            journalPath = argv[++i];
+        } else if (arg == "--output-root" && i + 1 < argc) {
+            outputRoot = argv[++i];
+        } else if (arg == "--cache" && i + 1 < argc) {
+            m_cacheOverride = argv[++i];
+        } else if (arg == "--force") {
+            m_forceRender = true;
+        } else if (arg == "--resume") {
+            m_resumeBatch = true;
+        } else if (arg == "--watch") {
+            m_watchMode = true;
+        } else if (arg == "--jsonl") {
+            m_jsonlMode = true;
+        } else if (arg == "--serve" && i + 1 < argc) {
+            serveAddress = argv[++i];
+        } else if (arg == "--include" && i + 1 < argc) {
+            m_scanOptions.include.push_back(argv[++i]);
+        } else if (arg == "--exclude" && i + 1 < argc) {
+            m_scanOptions.exclude.push_back(argv[++i]);
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+    
+    if (!workerList.empty()) {
+        return runWorkerList(workerList, jobs, journalPath);
+    }
+    
+    if (jobs > 1) {
+        std::vector<std::string> stlFiles;
+        for (const auto& input : inputs) {
+            fs::path path(input);
+            if (fs::exists(path) && path.extension() == ".stl") {
+                stlFiles.push_back(input);
+            }
+        }
+        
+        if (stlFiles.size() > 1) {
+            return runProcessBatch(stlFiles, jobs, argv[0]);
+        }
+        
+        // Las carpetas se escanean mientras se renderizan: no hay lista que repartir de antemano
+        std::cerr << "Aviso: --jobs solo reparte varios archivos STL entre procesos; "
+                  << "se procesa en un solo proceso" << std::endl;
+    }
+    
     // Inicializar el renderer en modo headless para renderizado sin ventana
     if (!m_renderer->initializeHeadless(m_config.outputWidth, m_config.outputHeight)) {
         std::cerr << "Error al inicializar el renderer en modo headless" << std::endl;
@@ -98,46 +222,90 @@ int App::run(int argc, char* argv[]) {
     
     std::cout << "Renderer inicializado correctamente" << std::endl;
     
+    if (!serveAddress.empty()) {
+        int result = runServer(serveAddress);
+        saveConfig();
+        return result;
+    }
+    
+    if (m_jsonlMode) {
+        int result = runJsonl();
+        saveConfig();
+        return result;
+    }
+    
     // MODIFICACIÓN: Comprobar si hay múltiples archivos STL
     std::vector<std::string> stlFiles;
     
-    // Comprobar cada argumento para ver si son archivos STL válidos
-    for (int i = 1; i < argc; i++) {
-        fs::path path(argv[i]);
+    std::vector<std::string> directories;
+    std::vector<fs::path> seenDirectories;
+    
+    // Comprobar cada argumento para ver si son archivos STL válidos o carpetas
+    for (const auto& input : inputs) {
+        fs::path path(input);
         if (fs::exists(path) && path.extension() == ".stl") {
-            stlFiles.push_back(argv[i]);
-            std::cout << "Archivo STL detectado: " << argv[i] << std::endl;
+            stlFiles.push_back(input);
+            std::cout << "Archivo STL detectado: " << input << std::endl;
+        } else if (fs::is_directory(path)) {
+            // La misma carpeta dos veces compartiría manifiesto y se pisarían las entradas
+            std::error_code ec;
+            fs::path canonical = fs::weakly_canonical(path, ec);
+            if (!ec && std::find(seenDirectories.begin(), seenDirectories.end(), canonical) != seenDirectories.end()) {
+                std::cout << "Carpeta repetida, se ignora: " << input << std::endl;
+                continue;
+            }
+            seenDirectories.push_back(canonical);
+            directories.push_back(input);
+            std::cout << "Carpeta detectada: " << input << std::endl;
         }
     }
     
+    if (m_watchMode) {
+        if (directories.empty()) {
+            std::cerr << "Error: --watch necesita al menos una carpeta" << std::endl;
+            return -1;
+        }
+        int result = runWatch(directories, resolveOutputRoots(directories, outputRoot));
+        saveConfig();
+        return result;
+    }
+    
+    // Carpetas: escaneo recursivo que alimenta el lote mientras se renderiza
+    if (stlFiles.empty() && !directories.empty()) {
+        bool success = false;
+        std::vector<std::string> outputRoots = resolveOutputRoots(directories, outputRoot);
+        for (size_t i = 0; i < directories.size(); ++i) {
+            success = renderDirectory(directories[i], outputRoots[i]) || success;
+        }
+        
+        saveConfig();
+        return success ? 0 : -1;
+    }
+    
     // Si hay múltiples archivos STL, procesarlos como conjunto
     if (stlFiles.size() > 1) {
         std::cout << "===== PROCESANDO " << stlFiles.size() << " ARCHIVOS STL ARRASTRADOS =====" << std::endl;
         
-        int filesProcessed = 0;
-        int filesSuccess = 0;
+        int filesProcessed = static_cast<int>(stlFiles.size());
+        auto batchStart = std::chrono::steady_clock::now();
         
-        // Procesar cada archivo como lo haría renderDirectory
+        // Mismo lote en paralelo que renderDirectory
+        std::vector<std::pair<std::string, std::string>> jobs;
         for (const auto& filePath : stlFiles) {
-            fs::path path(filePath);
-            fs::path outputPath = path;
+            fs::path outputPath = filePath;
             outputPath.replace_extension();
             outputPath += "_png.png";
-            
-            std::cout << "Procesando: " << filePath << " -> " << outputPath.string() << std::endl;
-            std::cout << "Procesando: " << path.filename().string() << std::endl;
-            
-            filesProcessed++;
-            if (renderSingleFile(filePath, outputPath.string())) {
-                filesSuccess++;
-                std::cout << "✓ Imagen guardada: " << outputPath.filename().string() << std::endl;
-            } else {
-                std::cerr << "✗ Error al procesar: " << path.filename().string() << std::endl;
-            }
+            jobs.emplace_back(filePath, outputPath.string());
         }
         
+        // Diario en la carpeta de trabajo: --resume retoma el mismo lote tras un corte
+        BatchJournal journal(BatchJournal::kFileName);
+        journal.open(m_resumeBatch);
+        int filesSuccess = renderBatch(jobs, &journal);
+        
         std::cout << "Procesamiento completado. " << filesSuccess << "/" << filesProcessed 
                 << " archivos procesados correctamente" << std::endl;
+        printBatchTiming(filesProcessed, batchStart);
         
         saveConfig();
         return filesSuccess > 0 ? 0 : -1;
@@ -167,10 +335,89 @@ int App::run(int argc, char* argv[]) {
     }
 }
 
+int App::runProcessBatch(const std::vector<std::string>& stlFiles, int jobs, const char* argv0) {
+    std::cout << "===== PROCESANDO " << stlFiles.size() << " ARCHIVOS STL EN " << jobs << " PROCESOS =====" << std::endl;
+    
+    // Mismos nombres de salida que el lote en un solo proceso
+    std::vector<std::pair<std::string, std::string>> files;
+    for (const auto& filePath : stlFiles) {
+        fs::path outputPath = filePath;
+        outputPath.replace_extension();
+        outputPath += "_png.png";
+        files.emplace_back(filePath, outputPath.string());
+    }
+    
+    ProcessBatch batch(ProcessBatch::currentExecutable(argv0), jobs);
+    batch.setScheduleBySize(m_config.batchScheduleBySize);
+    
+    // Los hijos leen config.ini; las opciones de esta ejecución van en su línea de comandos
+    std::vector<std::string> workerArguments;
+    if (!m_cacheOverride.empty()) {
+        workerArguments.push_back("--cache");
+        workerArguments.push_back(m_cacheOverride);
+    }
+    batch.setWorkerArguments(workerArguments);
+    
+    // Mismo diario que el lote en un solo proceso; los hijos añaden sus líneas
+    BatchJournal journal(BatchJournal::kFileName);
+    if (journal.open(m_resumeBatch)) {
+        batch.setJournal(&journal);
+    }
+    ProcessBatchResult result = batch.run(files);
+    
+    double perFileMs = files.empty() ? 0.0 : result.seconds * 1000.0 / files.size();
+    std::cout << "Procesamiento completado. " << result.succeeded << "/" << files.size()
+              << " archivos procesados correctamente, " << result.failed << " fallidos" << std::endl;
+    std::cout << "Tiempo del lote: " << result.seconds * 1000.0 << " ms (" << perFileMs << " ms/archivo). "
+              << result.processesLaunched << " procesos lanzados, " << result.crashes << " terminaron de forma anormal" << std::endl;
+    
+    return result.succeeded > 0 ? 0 : -1;
+}
+
+int App::runWorkerList(const std::string& listPath, int jobs, const std::string& journalPath) {
+    m_workerProcess = true;
+    
+    std::vector<std::pair<std::string, std::string>> files;
+    if (!ProcessBatch::readWorkerList(listPath, files)) {
+        std::cerr << "Error: No se pudo leer la lista de trabajo: " << listPath << std::endl;
+        return -1;
+    }
+    
+    // Repartir los núcleos entre los procesos hermanos en lugar de que cada uno use todos
+    int cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) / std::max(1, jobs));
+    if (m_config.batchLoaderThreads <= 0) {
+        m_config.batchLoaderThreads = std::max(1, cores / 2);
+    }
+    if (m_config.batchEncoderThreads <= 0) {
+        m_config.batchEncoderThreads = std::max(1, cores - m_config.batchLoaderThreads);
+    }
+    
+    // El presupuesto de memoria es del lote entero: cada proceso hermano se queda su parte
+    if (m_config.batchMemoryBudgetMB > 0) {
+        m_config.batchMemoryBudgetMB = std::max(1, m_config.batchMemoryBudgetMB / std::max(1, jobs));
+    }
+    
+    std::cout << "Proceso de trabajo: " << files.size() << " archivos de " << listPath << std::endl;
+    
+    // El padre ya creó o truncó el diario: aquí solo se añade (escrituras en modo append)
+    std::unique_ptr<BatchJournal> journal;
+    if (!journalPath.empty()) {
+        journal = std::make_unique<BatchJournal>(journalPath);
+        if (!journal->open(true)) {
+            journal.reset();
+        }
+    }
+    int saved = renderBatch(files, journal.get());
+    return saved == static_cast<int>(files.size()) ? 0 : 1;
+}
+
 int App::runInteractive() {
     std::cout << "App::runInteractive() - Iniciando interfaz gráfica" << std::endl;
     std::cout << "Iniciando interfaz gráfica..." << std::endl;
     
+    // La vista previa necesita un contexto OpenGL aunque la salida use el rasterizador por CPU
+    m_renderer->setBackend(RenderBackend::OpenGL);
+    
     // Inicializar renderer con una ventana más grande para mejor visualización
     if (!m_renderer->initialize(1024, 768)) {
         std::cerr << "Error al inicializar el renderer en modo interactivo" << std::endl;
@@ -206,8 +453,36 @@ int App::runInteractive() {
     std::cout << "Entrando en bucle principal" << std::endl;
     
     while (!glfwWindowShouldClose(m_renderer->getWindow()) && m_running) {
-        // Procesar eventos
-        glfwPollEvents();
+        // Procesar eventos: con frames pendientes no se bloquea; en reposo se espera
+        // a la siguiente entrada (el timeout mantiene vivo el bucle sin consumir CPU)
+        bool jobsRunning = m_jobQueue->isBusy();
+        if (m_gui->needsRedraw() || m_asyncLoader->isBusy()) {
+            glfwPollEvents();
+        } else {
+            glfwWaitEventsTimeout(jobsRunning ? kJobRefreshSeconds : kIdleWaitSeconds);
+        }
+        
+        // La cola de renders avanza en su hilo: refrescar el progreso con un ritmo moderado
+        if (jobsRunning) {
+            m_gui->requestRedraw(1);
+        }
+        
+        // Carga en segundo plano: subir lo leído con un presupuesto fijo por frame
+        if (m_asyncLoader->isBusy()) {
+            if (m_asyncLoader->update(*m_renderer, kUploadBudgetMs)) {
+                bool loaded = m_asyncLoader->getState() == AsyncLoadState::Finished;
+                if (loaded) {
+                    applyModelCamera();
+                }
+                m_gui->onModelLoaded(loaded);
+            }
+            m_gui->requestRedraw(1);
+        }
+        
+        // Sin cambios desde el último frame: no redibujar
+        if (!m_gui->needsRedraw()) {
+            continue;
+        }
         
         // Limpiar pantalla (con el color de fondo)
         glClearColor(m_config.backgroundColor.r, m_config.backgroundColor.g, m_config.backgroundColor.b, 1.0f);
@@ -216,14 +491,12 @@ int App::runInteractive() {
         // Aplicar configuración actual de cámara al renderer
         updateRendererCamera();
         
-        // Renderizar escena (pero no mostrarla aún, ImGui se dibujará encima)
-        m_renderer->render();
-        
-        // Renderizar GUI encima
+        // Renderizar GUI (incluye la vista previa en textura)
         m_gui->render();
         
         // Intercambiar buffers
         glfwSwapBuffers(m_renderer->getWindow());
+        m_gui->frameRendered();
     }
     
     // Guardar configuración al salir
@@ -272,21 +545,7 @@ bool App::loadModel(const std::string& filename) {
     
     if (m_stlLoader->loadModel(filename, *m_renderer)) {
         std::cout << "Modelo cargado correctamente: " << filename << std::endl;
-        
-        // Ajustar cámara automáticamente
-        m_renderer->centerCamera();
-        std::cout << "Cámara centrada" << std::endl;
-        
-        // Aplicar configuración personalizada de cámara si existe
-        if (m_config.cameraYaw != 0.0f || m_config.cameraPitch != 0.0f || m_config.cameraDistance != 0.0f) {
-            float yaw = m_config.cameraYaw != 0.0f ? m_config.cameraYaw : 0.8f;
-            float pitch = m_config.cameraPitch != 0.0f ? m_config.cameraPitch : 0.5f;
-            float distance = m_config.cameraDistance != 0.0f ? m_config.cameraDistance : 2.0f;
-            
-            std::cout << "Aplicando configuración de cámara: yaw=" << yaw << ", pitch=" << pitch << ", distance=" << distance << std::endl;
-            m_renderer->setCameraOrbit(yaw, pitch, distance);
-        }
-        
+        applyModelCamera();
         return true;
     }
     
@@ -294,6 +553,51 @@ bool App::loadModel(const std::string& filename) {
     return false;
 }
 
+bool App::loadModelAsync(const std::string& filename) {
+    std::cout << "App::loadModelAsync() - Cargando en segundo plano: " << filename << std::endl;
+    return m_asyncLoader->start(filename);
+}
+
+void App::enqueueRender(const std::string& inputFile, const std::string& outputFile) {
+    // Los parámetros se copian ahora: cambiar colores después no afecta a los trabajos encolados
+    RenderJob job;
+    job.inputFile = inputFile;
+    job.outputFile = outputFile;
+    job.settings.width = m_config.outputWidth;
+    job.settings.height = m_config.outputHeight;
+    job.settings.modelColor = m_config.modelColor;
+    job.settings.backgroundColor = m_config.backgroundColor;
+    job.settings.transparentBackground = m_config.transparentBackground;
+    job.settings.cameraYaw = m_config.cameraYaw;
+    job.settings.cameraPitch = m_config.cameraPitch;
+    job.settings.cameraDistance = m_config.cameraDistance;
+    job.settings.samples = m_config.outputSamples;
+    
+    m_jobQueue->enqueue(job);
+}
+
+void App::cancelModelLoad() {
+    if (m_asyncLoader->isBusy()) {
+        m_asyncLoader->cancel();
+    }
+}
+
+void App::applyModelCamera() {
+    // Ajustar cámara automáticamente
+    m_renderer->centerCamera();
+    std::cout << "Cámara centrada" << std::endl;
+    
+    // Aplicar configuración personalizada de cámara si existe
+    if (m_config.cameraYaw != 0.0f || m_config.cameraPitch != 0.0f || m_config.cameraDistance != 0.0f) {
+        float yaw = m_config.cameraYaw != 0.0f ? m_config.cameraYaw : 0.8f;
+        float pitch = m_config.cameraPitch != 0.0f ? m_config.cameraPitch : 0.5f;
+        float distance = m_config.cameraDistance != 0.0f ? m_config.cameraDistance : 2.0f;
+        
+        std::cout << "Aplicando configuración de cámara: yaw=" << yaw << ", pitch=" << pitch << ", distance=" << distance << std::endl;
+        m_renderer->setCameraOrbit(yaw, pitch, distance);
+    }
+}
+
 bool App::saveImage(const std::string& outputFile) {
     std::cout << "App::saveImage() - Guardando imagen en: " << outputFile << std::endl;
     
@@ -334,8 +638,9 @@ bool App::renderSingleFile(const std::string& inputFile, const std::string& outp
     
     // En modo silencio (no interactivo)
     if (m_silentMode) {
-        // Inicializar renderer en modo headless
-        if (!m_renderer->initializeHeadless(1024, 1024)) {
+        // El contexto headless se crea una vez por proceso; las siguientes
+        // llamadas lo reutilizan y solo reinician la escena
+        if (!m_renderer->initializeHeadless(m_config.outputWidth, m_config.outputHeight)) {
             std::cerr << "Error al inicializar el renderer en modo headless" << std::endl;
             return false;
         }
@@ -372,6 +677,13 @@ bool App::renderSingleFile(const std::string& inputFile, const std::string& outp
             return false;
         }
         
+        // Llamada directa sin run() (archivo arrastrado sobre el ejecutable)
+        if (!m_renderer->isInitialized() &&
+            !m_renderer->initializeHeadless(m_config.outputWidth, m_config.outputHeight)) {
+            std::cerr << "Error al inicializar el renderer en modo headless" << std::endl;
+            return false;
+        }
+        
         // Cargar modelo
         if (!loadModel(inputFile)) {
             std::cerr << "Error al cargar el modelo" << std::endl;
@@ -393,7 +705,7 @@ bool App::renderSingleFile(const std::string& inputFile, const std::string& outp
     }
 }
 
-bool App::renderDirectory(const std::string& directory) {
+bool App::renderDirectory(const std::string& directory, const std::string& outputRoot) {
     std::cout << "renderDirectory(): Procesando directorio " << directory << std::endl;
     std::cout << "Procesando directorio: " << directory << std::endl;
     
@@ -404,29 +716,73 @@ bool App::renderDirectory(const std::string& directory) {
             return false;
         }
         
-        int filesProcessed = 0;
-        int filesSuccess = 0;
+        if (!prepareBatchRenderer()) {
+            return false;
+        }
+        
+        auto batchStart = std::chrono::steady_clock::now();
+        
+        BatchPipelineSettings settings = makeBatchSettings();
+        settings.stampSources = true;
+        
+        // Manifiesto junto a las salidas: solo se renderiza lo nuevo o modificado
+        fs::path manifestDir = manifestDirectory(directory, outputRoot);
+        std::error_code dirError;
+        fs::create_directories(manifestDir, dirError);
+        RenderManifest manifest((manifestDir / RenderManifest::kFileName).string(),
+                                RenderManifest::describeSettings(settings.render, m_config.renderBackend));
+        if (!m_forceRender) {
+            manifest.load();
+        }
+        
+        // El manifiesto se guarda al final; el diario cubre un corte a mitad del lote
+        BatchJournal journal((manifestDir / BatchJournal::kFileName).string());
+        journal.open(m_resumeBatch);
+        
+        // El render empieza con los primeros archivos encontrados, sin esperar al escaneo
+        DirectoryScanner scanner(m_scanOptions);
+        BatchPipeline pipeline(*m_renderer, settings);
+        attachRenderCache(pipeline, settings);
+        ScanStats scanStats;
+        std::atomic<int> resumed(0);
         
-        // Iterar sobre todos los archivos .stl en el directorio
-        for (const auto& entry : fs::directory_iterator(directory)) {
-            if (entry.is_regular_file() && entry.path().extension() == ".stl") {
-                // Generar nombre de archivo de salida
-                fs::path outputPath = entry.path();
-                outputPath.replace_extension("png");
+        pipeline.setResultCallback([&](const BatchResult& result) {
+            if (result.success) {
+                manifest.record(fs::path(result.inputFile).lexically_relative(directory).generic_string(),
+                                result.source, result.outputFile);
+            }
+            journal.record(result.inputFile, result.outputFile, result.success);
+        });
+        
+        int filesRendered = pipeline.run([&](BatchPipeline& batch) {
+            scanStats = scanner.scan(directory, [&](const fs::path& file, const fs::path& relative) {
+                std::string outputPath = directoryOutputPath(file, relative, outputRoot);
                 
-                // Procesar el archivo
-                std::cout << "Procesando: " << entry.path().string() << " -> " << outputPath.string() << std::endl;
-                std::cout << "Procesando: " << entry.path().filename().string() << std::endl;
+                if (manifest.isUpToDate(relative.generic_string(), file, outputPath)) {
+                    return;
+                }
                 
-                filesProcessed++;
-                if (renderSingleFile(entry.path().string(), outputPath.string())) {
-                    filesSuccess++;
+                // Hecho antes del corte: pasa al manifiesto sin renderizarlo otra vez
+                if (journal.isCompleted(file.string(), outputPath)) {
+                    manifest.record(relative.generic_string(), RenderManifest::stampFile(file.string()), outputPath);
+                    resumed++;
+                    return;
                 }
-            }
-        }
+                
+                batch.submit(file.string(), outputPath);
+            });
+        });
+        
+        manifest.save();
+        
+        int filesProcessed = static_cast<int>(scanStats.matched);
+        int filesSkipped = static_cast<int>(manifest.getSkipped());
+        int filesSuccess = filesRendered + filesSkipped + resumed.load();
         
         // Mostrar resumen
-        std::cout << "Directorio procesado. " << filesSuccess << "/" << filesProcessed << " archivos procesados correctamente" << std::endl;
+        std::cout << "Directorio procesado. " << filesSuccess << "/" << filesProcessed << " archivos procesados correctamente ("
+                  << filesSkipped << " sin cambios desde el último lote, " << resumed.load() << " retomados del diario)" << std::endl;
+        printBatchTiming(filesProcessed, batchStart);
         
         return filesSuccess > 0;
     } catch (const std::exception& e) {
@@ -435,6 +791,352 @@ bool App::renderDirectory(const std::string& directory) {
     }
 }
 
+std::string App::directoryOutputPath(const fs::path& file, const fs::path& relative, const std::string& outputRoot) {
+    // Sin raíz de salida el PNG queda junto al STL; con ella se replica el árbol
+    fs::path outputPath = outputRoot.empty() ? file : fs::path(outputRoot) / relative;
+    outputPath.replace_extension("png");
+    if (!outputRoot.empty()) {
+        std::error_code ec;
+        fs::create_directories(outputPath.parent_path(), ec);
+    }
+    return outputPath.string();
+}
+
+std::vector<std::string> App::resolveOutputRoots(const std::vector<std::string>& directories, const std::string& outputRoot) {
+    if (outputRoot.empty() || directories.size() <= 1) {
+        return std::vector<std::string>(directories.size(), outputRoot);
+    }
+    
+    std::vector<std::string> roots;
+    std::unordered_map<std::string, int> used;
+    for (const auto& directory : directories) {
+        // "carpeta/", "." o rutas relativas: el nombre real de la carpeta
+        std::error_code ec;
+        fs::path canonical = fs::weakly_canonical(fs::path(directory), ec);
+        std::string name = (ec ? fs::path(directory) : canonical).filename().string();
+        if (name.empty() || name == "." || name == "..") {
+            name = "carpeta";
+        }
+        
+        int count = ++used[name];
+        if (count > 1) {
+            name += "_" + std::to_string(count);
+        }
+        roots.push_back((fs::path(outputRoot) / name).string());
+    }
+    return roots;
+}
+
+fs::path App::manifestDirectory(const std::string& directory, const std::string& outputRoot) {
+    return outputRoot.empty() ? fs::path(directory) : fs::path(outputRoot);
+}
+
+int App::runWatch(const std::vector<std::string>& directories, const std::vector<std::string>& outputRoots) {
+    std::cout << "===== VIGILANDO " << directories.size() << " CARPETAS =====" << std::endl;
+    
+    if (!prepareBatchRenderer()) {
+        return -1;
+    }
+    
+    // Vigilar antes de ponerse al día: lo que llegue durante la puesta al día sale en poll
+    // y el manifiesto descarta lo que ya se renderizó
+    FolderWatcher watcher(m_scanOptions, m_config.watchDebounceMs);
+    for (const auto& directory : directories) {
+        if (!watcher.addRoot(directory)) {
+            return -1;
+        }
+    }
+    
+    g_stopRequested = false;
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+    
+    // Primero lo que llegó con el servicio parado (el manifiesto omite lo que no cambió)
+    for (size_t i = 0; i < directories.size() && !g_stopRequested; ++i) {
+        renderDirectory(directories[i], outputRoots[i]);
+    }
+    
+    BatchPipelineSettings settings = makeBatchSettings();
+    settings.stampSources = true;
+    std::string parameters = RenderManifest::describeSettings(settings.render, m_config.renderBackend);
+    
+    // Se cargan después de la puesta al día, que escribe en los mismos archivos
+    std::vector<std::unique_ptr<RenderManifest>> manifests;
+    for (size_t i = 0; i < directories.size(); ++i) {
+        fs::path manifestDir = manifestDirectory(directories[i], outputRoots[i]);
+        manifests.push_back(std::make_unique<RenderManifest>((manifestDir / RenderManifest::kFileName).string(), parameters));
+        manifests.back()->load();
+    }
+    
+    if (!g_stopRequested) {
+        std::cout << "Esperando archivos nuevos (Ctrl+C para terminar)" << std::endl;
+    }
+    
+    size_t rendered = 0;
+    bool manifestsDirty = false;
+    auto lastSave = std::chrono::steady_clock::now();
+    
+    while (!g_stopRequested) {
+        std::vector<WatchedFile> ready = watcher.poll(kWatchPollMs);
+        
+        // Cada tanda de archivos estables es un lote con el renderer y la caché ya listos
+        std::vector<std::pair<std::string, std::string>> files;
+        std::unordered_map<std::string, std::pair<size_t, std::string>> owners;
+        for (const auto& item : ready) {
+            std::string outputPath = directoryOutputPath(item.file, item.relative, outputRoots[item.root]);
+            std::string key = item.relative.generic_string();
+            
+            // Guardado otra vez sin cambios
+            if (manifests[item.root]->isUpToDate(key, item.file, outputPath)) {
+                continue;
+            }
+            files.emplace_back(item.file.string(), outputPath);
+            owners[item.file.string()] = std::make_pair(item.root, key);
+        }
+        
+        if (!files.empty()) {
+            std::cout << "Archivos nuevos o modificados: " << files.size() << std::endl;
+            
+            BatchPipeline pipeline(*m_renderer, settings);
+            attachRenderCache(pipeline, settings);
+            pipeline.setResultCallback([&](const BatchResult& result) {
+                auto owner = owners.find(result.inputFile);
+                if (result.success && owner != owners.end()) {
+                    manifests[owner->second.first]->record(owner->second.second, result.source, result.outputFile);
+                }
+            });
+            rendered += pipeline.run(files);
+            manifestsDirty = true;
+        }
+        
+        // Los manifiestos completos son grandes: se guardan de vez en cuando, no por archivo
+        auto now = std::chrono::steady_clock::now();
+        if (manifestsDirty && std::chrono::duration<double>(now - lastSave).count() >= kWatchManifestSaveSeconds) {
+            for (auto& manifest : manifests) {
+                manifest->save(false);
+            }
+            manifestsDirty = false;
+            lastSave = now;
+        }
+    }
+    
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    
+    for (auto& manifest : manifests) {
+        manifest->save(false);
+    }
+    
+    std::cout << "Vigilancia terminada: " << rendered << " imágenes generadas" << std::endl;
+    return 0;
+}
+
+int App::runServer(const std::string& address) {
+    std::cout << "===== SERVIDOR DE RENDERS =====" << std::endl;
+    
+    if (!prepareBatchRenderer()) {
+        return -1;
+    }
+    
+    RenderServerSettings settings;
+    settings.address = address;
+    settings.defaults = makeBatchSettings().render;
+    settings.maxClients = std::max(1, m_config.serverMaxClients);
+    settings.queueDepth = std::max(1, m_config.serverQueueDepth);
+    
+    g_stopRequested = false;
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+    
+    RenderServer server(*m_renderer, settings);
+    bool ok = server.run([]() { return g_stopRequested.load(); });
+    
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    return ok ? 0 : -1;
+}
+
+int App::runJsonl() {
+    std::cout << "===== TRABAJOS JSONL =====" << std::endl;
+    
+    if (!prepareBatchRenderer()) {
+        return -1;
+    }
+    
+    BatchPipelineSettings settings = makeBatchSettings();
+    // Un atlas a medio llenar retendría los resultados hasta cerrar stdin
+    settings.atlasColumns = 1;
+    // Con las colas llenas se deja de leer stdin: el orquestador ve la presión en la tubería
+    settings.inputQueueDepth = settings.queueDepth;
+    
+    BatchPipeline pipeline(*m_renderer, settings);
+    attachRenderCache(pipeline, settings);
+    
+    std::ostream results(m_resultsOutput ? m_resultsOutput : std::cout.rdbuf());
+    std::mutex resultsMutex;
+    std::unordered_map<size_t, std::string> ids;
+    size_t received = 0;
+    size_t rejected = 0;
+    std::atomic<size_t> failed(0);
+    
+    // Una línea completa por resultado, en el orden en que terminan
+    pipeline.setResultCallback([&](const BatchResult& result) {
+        if (!result.success) {
+            failed++;
+        }
+        std::lock_guard<std::mutex> lock(resultsMutex);
+        auto id = ids.find(result.id);
+        results << JobStream::formatResult(id != ids.end() ? id->second : std::to_string(result.id), result) << std::endl;
+        if (id != ids.end()) {
+            ids.erase(id);
+        }
+    });
+    
+    int saved = pipeline.run([&](BatchPipeline& batch) {
+        std::string line;
+        size_t lineNumber = 0;
+        while (std::getline(std::cin, line)) {
+            lineNumber++;
+            if (line.find_first_not_of(" \t\r") == std::string::npos) {
+                continue;
+            }
+            received++;
+            
+            // Sin id, el número de línea identifica el resultado
+            StreamJob job;
+            std::string error;
+            bool valid = JobStream::parseJob(line, batch.getDefaultSettings(), job, error);
+            if (job.id.empty()) {
+                job.id = std::to_string(lineNumber);
+            }
+            if (!valid) {
+                rejected++;
+                std::lock_guard<std::mutex> lock(resultsMutex);
+                results << JobStream::formatError(job.id, error) << std::endl;
+                continue;
+            }
+            
+            std::error_code ec;
+            fs::path outputDir = fs::path(job.outputFile).parent_path();
+            if (!outputDir.empty()) {
+                fs::create_directories(outputDir, ec);
+            }
+            
+            BatchJob batchJob;
+            batchJob.id = lineNumber;
+            batchJob.inputFile = job.inputFile;
+            batchJob.outputFile = job.outputFile;
+            batchJob.settings = job.settings;
+            if (!renderCacheDirectory().empty()) {
+                batchJob.cacheParameters = RenderManifest::describeSettings(job.settings, m_config.renderBackend);
+            }
+            {
+                std::lock_guard<std::mutex> lock(resultsMutex);
+                ids[lineNumber] = job.id;
+            }
+            if (!batch.submit(std::move(batchJob))) {
+                break;
+            }
+        }
+    });
+    
+    std::cout << "Trabajos JSONL: " << received << " recibidos, " << saved << " guardados, "
+              << failed.load() << " fallidos, " << rejected << " inválidos" << std::endl;
+    
+    // Como los demás lotes: quien lanza el proceso ve el fallo sin leer cada línea
+    return (failed.load() > 0 || rejected > 0) ? -1 : 0;
+}
+
+void App::printBatchTiming(int filesProcessed, std::chrono::steady_clock::time_point batchStart) {
+    double totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - batchStart).count();
+    double perFileMs = filesProcessed > 0 ? totalMs / filesProcessed : 0.0;
+    
+    // El contexto debería haberse creado una sola vez, antes del lote
+    std::cout << "Tiempo del lote: " << totalMs << " ms (" << perFileMs << " ms/archivo). "
+              << "Contexto inicializado " << m_renderer->getContextInitCount() << " vez/veces en "
+              << m_renderer->getContextInitMilliseconds() << " ms" << std::endl;
+}
+
+int App::renderBatch(const std::vector<std::pair<std::string, std::string>>& files, BatchJournal* journal) {
+    // Lo terminado antes del corte cuenta como guardado y no se vuelve a renderizar
+    std::vector<std::pair<std::string, std::string>> pending;
+    int resumed = 0;
+    for (const auto& file : files) {
+        if (journal && journal->isCompleted(file.first, file.second)) {
+            resumed++;
+        } else {
+            pending.push_back(file);
+        }
+    }
+    if (resumed > 0) {
+        std::cout << resumed << " archivos ya terminados según el diario, quedan " << pending.size() << std::endl;
+    }
+    
+    if (pending.empty() || !prepareBatchRenderer()) {
+        return resumed;
+    }
+    
+    BatchPipelineSettings settings = makeBatchSettings();
+    BatchPipeline pipeline(*m_renderer, settings);
+    attachRenderCache(pipeline, settings);
+    if (journal) {
+        pipeline.setResultCallback([journal](const BatchResult& result) {
+            journal->record(result.inputFile, result.outputFile, result.success);
+        });
+    }
+    return resumed + pipeline.run(pending);
+}
+
+bool App::prepareBatchRenderer() {
+    // El contexto se crea una vez para todo el lote (el hilo actual hace la parte de OpenGL)
+    if ((m_silentMode || !m_renderer->isInitialized()) &&
+        !m_renderer->initializeHeadless(m_config.outputWidth, m_config.outputHeight)) {
+        std::cerr << "Error al inicializar el renderer en modo headless" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+BatchPipelineSettings App::makeBatchSettings() const {
+    BatchPipelineSettings settings;
+    settings.render.width = m_config.outputWidth;
+    settings.render.height = m_config.outputHeight;
+    settings.render.modelColor = m_config.modelColor;
+    settings.render.backgroundColor = m_config.backgroundColor;
+    settings.render.transparentBackground = m_config.transparentBackground;
+    settings.render.cameraYaw = m_config.cameraYaw;
+    settings.render.cameraPitch = m_config.cameraPitch;
+    settings.render.cameraDistance = m_config.cameraDistance;
+    settings.render.samples = m_config.outputSamples;
+    settings.atlasColumns = m_config.atlasColumns;
+    settings.loaderThreads = m_config.batchLoaderThreads;
+    settings.renderThreads = m_config.batchRenderThreads;
+    settings.encoderThreads = m_config.batchEncoderThreads;
+    settings.queueDepth = m_config.batchQueueDepth;
+    settings.scheduleBySize = m_config.batchScheduleBySize;
+    settings.smallJobTriangles = m_config.batchSmallJobTriangles;
+    settings.memoryBudgetMB = m_config.batchMemoryBudgetMB;
+    return settings;
+}
+
+void App::attachRenderCache(BatchPipeline& pipeline, const BatchPipelineSettings& settings) {
+    const std::string& directory = renderCacheDirectory();
+    if (directory.empty()) {
+        return;
+    }
+    
+    // El índice se construye una vez y sirve para todos los lotes del proceso
+    if (!m_renderCache || m_renderCache->getDirectory() != directory) {
+        uint64_t maxBytes = static_cast<uint64_t>(std::max(1, m_config.renderCacheMaxMB)) * 1024 * 1024;
+        m_renderCache = std::make_unique<RenderCache>(directory, maxBytes);
+    }
+    pipeline.setRenderCache(m_renderCache.get(), RenderManifest::describeSettings(settings.render, m_config.renderBackend));
+}
+
+const std::string& App::renderCacheDirectory() const {
+    return m_cacheOverride.empty() ? m_config.renderCacheDirectory : m_cacheOverride;
+}
+
 bool App::processDirectory(const std::string& directory) {
     // Alias para renderDirectory
     return renderDirectory(directory);
@@ -474,6 +1176,25 @@ void App::saveConfig() {
     configFile << "outputWidth=" << m_config.outputWidth << "\n";
     configFile << "outputHeight=" << m_config.outputHeight << "\n";
     configFile << "transparentBackground=" << (m_config.transparentBackground ? "true" : "false") << "\n";
+    configFile << "outputSamples=" << m_config.outputSamples << "\n";
+    configFile << "renderBackend=" << m_config.renderBackend << "\n";
+    configFile << "headlessContext=" << m_config.headlessContext << "\n\n";
+    
+    // Procesamiento por lotes
+    configFile << "# Procesamiento por lotes\n";
+    configFile << "atlasColumns=" << m_config.atlasColumns << "\n";
+    configFile << "batchLoaderThreads=" << m_config.batchLoaderThreads << "\n";
+    configFile << "batchRenderThreads=" << m_config.batchRenderThreads << "\n";
+    configFile << "batchEncoderThreads=" << m_config.batchEncoderThreads << "\n";
+    configFile << "batchQueueDepth=" << m_config.batchQueueDepth << "\n";
+    configFile << "batchScheduleBySize=" << (m_config.batchScheduleBySize ? "true" : "false") << "\n";
+    configFile << "batchSmallJobTriangles=" << m_config.batchSmallJobTriangles << "\n";
+    configFile << "batchMemoryBudgetMB=" << m_config.batchMemoryBudgetMB << "\n";
+    configFile << "renderCacheDirectory=" << m_config.renderCacheDirectory << "\n";
+    configFile << "renderCacheMaxMB=" << m_config.renderCacheMaxMB << "\n";
+    configFile << "watchDebounceMs=" << m_config.watchDebounceMs << "\n";
+    configFile << "serverMaxClients=" << m_config.serverMaxClients << "\n";
+    configFile << "serverQueueDepth=" << m_config.serverQueueDepth << "\n";
     
     configFile.close();
     
@@ -538,6 +1259,38 @@ bool App::loadConfig() {
                     m_config.outputHeight = std::stoi(value);
                 } else if (key == "transparentBackground") {
                     m_config.transparentBackground = (value == "true" || value == "1");
+                } else if (key == "outputSamples") {
+                    m_config.outputSamples = std::stoi(value);
+                } else if (key == "renderBackend") {
+                    m_config.renderBackend = value;
+                } else if (key == "headlessContext") {
+                    m_config.headlessContext = value;
+                } else if (key == "atlasColumns") {
+                    m_config.atlasColumns = std::stoi(value);
+                } else if (key == "batchLoaderThreads") {
+                    m_config.batchLoaderThreads = std::stoi(value);
+                } else if (key == "batchRenderThreads") {
+                    m_config.batchRenderThreads = std::stoi(value);
+                } else if (key == "batchEncoderThreads") {
+                    m_config.batchEncoderThreads = std::stoi(value);
+                } else if (key == "batchQueueDepth") {
+                    m_config.batchQueueDepth = std::stoi(value);
+                } else if (key == "batchScheduleBySize") {
+                    m_config.batchScheduleBySize = (value == "true" || value == "1");
+                } else if (key == "batchSmallJobTriangles") {
+                    m_config.batchSmallJobTriangles = std::stoi(value);
+                } else if (key == "batchMemoryBudgetMB") {
+                    m_config.batchMemoryBudgetMB = std::stoi(value);
+                } else if (key == "renderCacheDirectory") {
+                    m_config.renderCacheDirectory = value;
+                } else if (key == "renderCacheMaxMB") {
+                    m_config.renderCacheMaxMB = std::stoi(value);
+                } else if (key == "watchDebounceMs") {
+                    m_config.watchDebounceMs = std::stoi(value);
+                } else if (key == "serverMaxClients") {
+                    m_config.serverMaxClients = std::stoi(value);
+                } else if (key == "serverQueueDepth") {
+                    m_config.serverQueueDepth = std::stoi(value);
                 }
             }
         }
@@ -556,6 +1309,22 @@ bool App::loadConfig() {
     std::cout << "  - outputWidth: " << m_config.outputWidth << std::endl;
     std::cout << "  - outputHeight: " << m_config.outputHeight << std::endl;
     std::cout << "  - transparentBackground: " << (m_config.transparentBackground ? "true" : "false") << std::endl;
+    std::cout << "  - outputSamples: " << m_config.outputSamples << std::endl;
+    std::cout << "  - renderBackend: " << m_config.renderBackend << std::endl;
+    std::cout << "  - headlessContext: " << m_config.headlessContext << std::endl;
+    std::cout << "  - atlasColumns: " << m_config.atlasColumns << std::endl;
+    std::cout << "  - batchLoaderThreads: " << m_config.batchLoaderThreads << std::endl;
+    std::cout << "  - batchRenderThreads: " << m_config.batchRenderThreads << std::endl;
+    std::cout << "  - batchEncoderThreads: " << m_config.batchEncoderThreads << std::endl;
+    std::cout << "  - batchQueueDepth: " << m_config.batchQueueDepth << std::endl;
+    std::cout << "  - batchScheduleBySize: " << (m_config.batchScheduleBySize ? "true" : "false") << std::endl;
+    std::cout << "  - batchSmallJobTriangles: " << m_config.batchSmallJobTriangles << std::endl;
+    std::cout << "  - batchMemoryBudgetMB: " << m_config.batchMemoryBudgetMB << std::endl;
+    std::cout << "  - renderCacheDirectory: " << m_config.renderCacheDirectory << std::endl;
+    std::cout << "  - renderCacheMaxMB: " << m_config.renderCacheMaxMB << std::endl;
+    std::cout << "  - watchDebounceMs: " << m_config.watchDebounceMs << std::endl;
+    std::cout << "  - serverMaxClients: " << m_config.serverMaxClients << std::endl;
+    std::cout << "  - serverQueueDepth: " << m_config.serverQueueDepth << std::endl;
     
     return true;
 }
@@ -575,6 +1344,8 @@ void App::shutdown() {
     // Limpiar recursos usando reset() en lugar de delete
     m_renderer.reset();
     m_gui.reset();
+    m_jobQueue.reset();
+    m_asyncLoader.reset();
     m_stlLoader.reset();
 }
 
@@ -693,6 +1464,16 @@ void App::printHelp() {
     std::cout << "  -bg, --background R G B\tEstablece el color de fondo (valores entre 0.0 y 1.0)" << std::endl;
     std::cout << "  -a, --angle A\t\tEstablece el ángulo de la cámara en grados" << std::endl;
     std::cout << "  -o, --output ARCHIVO\tEstablece el archivo de salida para la imagen renderizada" << std::endl;
+    std::cout << "  --jobs N\t\tReparte varios archivos STL entre N procesos" << std::endl;
+    std::cout << "  --output-root DIR\tCon una carpeta: escribe los PNG replicando su árbol en DIR" << std::endl;
+    std::cout << "  --cache DIR\t\tReutiliza imágenes de piezas idénticas guardadas en DIR (caché por contenido)" << std::endl;
+    std::cout << "  --jsonl\t\tLee trabajos JSON por stdin (uno por línea) y escribe un resultado JSON por línea en stdout" << std::endl;
+    std::cout << "  --serve ADDR\t\tServidor HTTP de renders en un socket Unix (ruta) o en [host:]puerto local" << std::endl;
+    std::cout << "  --watch\t\tVigila las carpetas y renderiza los STL nuevos o modificados hasta Ctrl+C" << std::endl;
+    std::cout << "  --resume\t\tContinúa un lote interrumpido sin repetir los archivos ya terminados" << std::endl;
+    std::cout << "  --force\t\tCon una carpeta: renderiza todo aunque el manifiesto diga que no cambió" << std::endl;
+    std::cout << "  --include GLOB\t\tCon una carpeta: solo archivos que coincidan (repetible)" << std::endl;
+    std::cout << "  --exclude GLOB\t\tCon una carpeta: omite archivos y carpetas que coincidan (repetible)" << std::endl;
     
     std::cout << "Se mostró la ayuda al usuario" << std::endl;
 }
@@ -799,8 +1580,7 @@ bool App::parseArguments(int argc, char* argv[]) {
 std::string App::getCurrentTimestamp() {
     auto now = std::chrono::system_clock::now();
     auto time = std::chrono::system_clock::to_time_t(now);
-    std::tm tm;
-    localtime_s(&tm, &time);
+    std::tm tm = localTime(time);
     
     std::stringstream ss;
     ss << std::put_time(&tm, "%Y%m%d_%H%M%S");
@@ -2,12 +2,19 @@
 
 #include "renderer.h"
 #include "stl_loader.h"
+#include "async_model_loader.h"
+#include "render_job_queue.h"
+#include "batch_pipeline.h"
+#include "directory_scanner.h"
+#include "render_cache.h"
+#include "batch_journal.h"
 #include "gui.h"
 #include <string>
 #include <memory>
 #include <vector>
 #include <fstream>
 #include <sstream>
+#include <chrono>
 
 // Estructura de configuración de la aplicación
 struct AppConfig {
@@ -22,9 +29,25 @@ struct AppConfig {
     int outputWidth = 1024;
     int outputHeight = 1024;
     bool transparentBackground = true;
+    int outputSamples = 1;          // Muestras MSAA de la imagen de salida (1 = sin antialiasing)
+    std::string renderBackend = "opengl";   // "opengl" o "software" (rasterizador por CPU)
+    std::string headlessContext = "auto";   // "auto", "egl", "egl-device", "osmesa" o "glfw"
     
     // Configuración de batch processing
     std::string batchDirectory = "";
+    int atlasColumns = 4;           // Miniaturas por fila del atlas en lotes (1 = desactivado)
+    int batchLoaderThreads = 0;     // Hilos que leen STL en lotes (0 = según los núcleos)
+    int batchRenderThreads = 1;     // Contextos OpenGL que renderizan a la vez en lotes (EGL/OSMesa)
+    int batchEncoderThreads = 0;    // Hilos que comprimen PNG en lotes (0 = según los núcleos)
+    int batchQueueDepth = 8;        // Capacidad de las colas entre etapas del lote
+    bool batchScheduleBySize = true;        // Lotes: los STL más grandes primero (y en --jobs, reparto por coste)
+    int batchSmallJobTriangles = 100000;    // Carril aparte para modelos más pequeños (0 = sin carril)
+    int batchMemoryBudgetMB = 0;    // Mallas en memoria a la vez en lotes (0 = sin límite); con --jobs se reparte
+    std::string renderCacheDirectory = "";  // Caché de renders por contenido (vacío = desactivada)
+    int renderCacheMaxMB = 4096;    // Tamaño máximo de la caché; se descartan las imágenes menos usadas
+    int watchDebounceMs = 2000;     // --watch: tiempo sin cambios antes de leer un archivo nuevo
+    int serverMaxClients = 32;      // --serve: conexiones atendidas a la vez
+    int serverQueueDepth = 64;      // --serve: renders en espera antes de responder 503
 };
 
 class App {
@@ -46,10 +69,23 @@ public:
     
     // Operaciones de archivos
     bool loadModel(const std::string& filename);
+    
+    // Carga en segundo plano para la interfaz (el modelo aparece al terminar de subirse)
+    bool loadModelAsync(const std::string& filename);
+    void cancelModelLoad();
+    AsyncModelLoader& getAsyncLoader() { return *m_asyncLoader; }
+    
+    // Render a archivo en segundo plano con la configuración actual (interfaz)
+    void enqueueRender(const std::string& inputFile, const std::string& outputFile);
+    RenderJobQueue& getJobQueue() { return *m_jobQueue; }
     bool saveImage(const std::string& outputFile);
     bool processDirectory(const std::string& directory);
     bool renderSingleFile(const std::string& inputFile, const std::string& outputFile);
-    bool renderDirectory(const std::string& directory);
+    
+    // Escanea la carpeta de forma recursiva (ver m_scanOptions) y renderiza mientras tanto;
+    // con outputRoot los PNG replican el árbol de carpetas allí en lugar de ir junto al STL.
+    // Los archivos sin cambios según el manifiesto de la carpeta se omiten
+    bool renderDirectory(const std::string& directory, const std::string& outputRoot = "");
     
     // Operaciones de configuración
     bool loadConfig();
@@ -74,9 +110,47 @@ private:
     std::string getCurrentTimestamp();
     Color parseColor(const std::string& colorStr);
     
+    // Renderiza pares (STL, PNG) con BatchPipeline; devuelve cuántos se guardaron. Con
+    // diario, cada archivo terminado se anota y los ya hechos al reanudar no se repiten
+    int renderBatch(const std::vector<std::pair<std::string, std::string>>& files, BatchJournal* journal = nullptr);
+    bool prepareBatchRenderer();
+    BatchPipelineSettings makeBatchSettings() const;
+    void attachRenderCache(BatchPipeline& pipeline, const BatchPipelineSettings& settings);
+    const std::string& renderCacheDirectory() const;
+    
+    // --jobs N: reparte los archivos entre N procesos hijos (--worker-list en cada hijo)
+    int runProcessBatch(const std::vector<std::string>& stlFiles, int jobs, const char* argv0);
+    int runWorkerList(const std::string& listPath, int jobs, const std::string& journalPath);
+    
+    // --watch: renderiza los STL que van apareciendo en las carpetas sin recrear el
+    // contexto ni las cachés; termina con Ctrl+C o SIGTERM
+    int runWatch(const std::vector<std::string>& directories, const std::vector<std::string>& outputRoots);
+    
+    // --serve: atiende peticiones de render con el contexto ya creado (ver RenderServer)
+    int runServer(const std::string& address);
+    
+    // --jsonl: trabajos con parámetros propios por stdin, un resultado JSON por línea en stdout
+    int runJsonl();
+    
+    // Salida de un STL encontrado en una carpeta: junto al STL o replicando el árbol en outputRoot
+    static std::string directoryOutputPath(const std::filesystem::path& file, const std::filesystem::path& relative,
+                                           const std::string& outputRoot);
+    
+    // Raíz de salida de cada carpeta: con varias carpetas y --output, cada una en su
+    // subcarpeta (su nombre, con _2, _3... si se repite) para que no se pisen las salidas
+    static std::vector<std::string> resolveOutputRoots(const std::vector<std::string>& directories,
+                                                       const std::string& outputRoot);
+    
+    // Carpeta del manifiesto y del diario de una raíz: junto a sus salidas
+    static std::filesystem::path manifestDirectory(const std::string& directory, const std::string& outputRoot);
+    
+    // Muestra el tiempo total del lote y el coste de inicialización del contexto
+    void printBatchTiming(int filesProcessed, std::chrono::steady_clock::time_point batchStart);
+    
     // Funciones para manejo de cámara
     void centerCameraIfNeeded();
     void updateRendererCamera();
+    void applyModelCamera();
     
     // Procesa los argumentos de línea de comandos
     bool processCommandLine(int argc, char* argv[]);
@@ -102,12 +176,23 @@ private:
     // Componentes de la aplicación
     std::unique_ptr<Renderer> m_renderer;
     std::unique_ptr<StlLoader> m_stlLoader;
+    std::unique_ptr<AsyncModelLoader> m_asyncLoader;
+    std::unique_ptr<RenderJobQueue> m_jobQueue;
     std::unique_ptr<Gui> m_gui;
     
     // Configuración
     AppConfig m_config;
     bool m_silentMode = false;      // Modo silencioso
     bool m_running = false;         // Estado de ejecución
+    bool m_workerProcess = false;   // Hijo de --jobs: no guarda config.ini (es del padre)
     std::string m_outputFile;       // Archivo de salida
     std::vector<std::string> m_inputFiles;  // Archivos de entrada
+    ScanOptions m_scanOptions;      // Filtros del escaneo de carpetas (--include/--exclude)
+    std::unique_ptr<RenderCache> m_renderCache;  // Se abre con el primer lote que la usa
+    std::string m_cacheOverride;    // --cache: solo esta ejecución, no se guarda en config.ini
+    bool m_forceRender = false;     // --force: ignora el manifiesto de las carpetas
+    bool m_resumeBatch = false;     // --resume: continúa el lote según su diario
+    bool m_watchMode = false;       // --watch: vigila las carpetas en lugar de procesarlas una vez
+    bool m_jsonlMode = false;       // --jsonl: trabajos por stdin
+    std::streambuf* m_resultsOutput = nullptr;  // stdout real con --jsonl (std::cout va a stderr)
 }; 
\ No newline at end of file
@@ -0,0 +1,213 @@
+#include "async_model_loader.h"
+#include "renderer.h"
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+// Triángulos por llamada a glBufferSubData (~2,3 MB de vértices)
+const size_t kUploadChunkTriangles = 16384;
+
+} // namespace
+
+AsyncModelLoader::AsyncModelLoader()
+    : m_state(AsyncLoadState::Idle)
+    , m_uploadProgress(0.0f)
+    , m_cancel(false)
+    , m_result(Running)
+    , m_bytesRead(0)
+    , m_totalBytes(0)
+    , m_trianglesParsed(0)
+    , m_pendingCapacity(0)
+    , m_uploadOffset(0)
+    , m_previewStarted(false)
+{
+}
+
+AsyncModelLoader::~AsyncModelLoader() {
+    cancel();
+    join();
+}
+
+bool AsyncModelLoader::start(const std::string& filename) {
+    // Solo una carga a la vez: la anterior se descarta
+    if (m_thread.joinable()) {
+        cancel();
+        join();
+    }
+    
+    m_filename = filename;
+    m_cancel = false;
+    m_result = Running;
+    m_bytesRead = 0;
+    m_totalBytes = 0;
+    m_trianglesParsed = 0;
+    m_uploadProgress = 0.0f;
+    m_pendingCapacity = 0;
+    m_pendingChunks.clear();
+    m_uploadQueue.clear();
+    m_uploadOffset = 0;
+    m_previewStarted = false;
+    
+    // Los avisos del cargador llegan desde el hilo de trabajo: solo encolan datos
+    StlLoadProgress progress;
+    progress.onBegin = [this](size_t capacityTriangles) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pendingCapacity = capacityTriangles;
+    };
+    progress.onTriangles = [this](const std::vector<Triangle>& triangles, float) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pendingChunks.push_back(triangles);
+    };
+    progress.onRead = [this](uint64_t bytesRead, uint64_t totalBytes, size_t triangles) {
+        m_bytesRead = bytesRead;
+        m_totalBytes = totalBytes;
+        m_trianglesParsed = triangles;
+    };
+    progress.isCancelled = [this]() {
+        return m_cancel.load();
+    };
+    m_loader.setProgressHandler(progress);
+    
+    try {
+        m_thread = std::thread(&AsyncModelLoader::run, this);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: No se pudo crear el hilo de carga: " << e.what() << std::endl;
+        m_state = AsyncLoadState::Failed;
+        return false;
+    }
+    
+    m_state = AsyncLoadState::Loading;
+    std::cout << "Carga asíncrona iniciada: " << filename << std::endl;
+    return true;
+}
+
+void AsyncModelLoader::cancel() {
+    m_cancel = true;
+}
+
+void AsyncModelLoader::run() {
+    bool success = m_loader.loadFile(m_filename);
+    
+    if (success) {
+        m_trianglesParsed = m_loader.getModel().triangles.size();
+        m_bytesRead = m_totalBytes.load();
+    }
+    
+    m_result = success ? Succeeded : (m_cancel ? Aborted : Error);
+}
+
+void AsyncModelLoader::join() {
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+bool AsyncModelLoader::update(Renderer& renderer, double budgetMs) {
+    if (!isBusy()) {
+        return false;
+    }
+    
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds((long long)(budgetMs * 1000.0));
+    
+    if (m_state == AsyncLoadState::Loading) {
+        // Vista previa progresiva mientras el hilo sigue leyendo
+        if (!uploadPreview(renderer, deadline)) {
+            return false;
+        }
+        
+        int result = m_result.load();
+        if (result == Running) {
+            return false;
+        }
+        
+        join();
+        m_uploadQueue.clear();
+        m_pendingChunks.clear();
+        
+        if (result != Succeeded) {
+            // No dejar en pantalla una vista previa a medias
+            if (m_previewStarted) {
+                renderer.resetScene();
+            }
+            
+            m_state = result == Aborted ? AsyncLoadState::Cancelled : AsyncLoadState::Failed;
+            std::cout << (result == Aborted ? "Carga cancelada: " : "Error en la carga asíncrona: ") << m_filename << std::endl;
+            return true;
+        }
+        
+        // La malla exacta sustituye a la vista previa, también por bloques
+        renderer.beginModelUpload(m_loader.releaseModel());
+        m_state = AsyncLoadState::Uploading;
+    }
+    
+    // Subir la malla definitiva hasta agotar el presupuesto del frame
+    bool done = false;
+    do {
+        done = renderer.uploadModelChunk(kUploadChunkTriangles);
+    } while (!done && std::chrono::steady_clock::now() < deadline);
+    
+    m_uploadProgress = renderer.getUploadProgress();
+    if (!done) {
+        return false;
+    }
+    
+    m_state = AsyncLoadState::Finished;
+    std::cout << "Modelo cargado en segundo plano: " << m_filename << " (" << m_trianglesParsed.load() << " triángulos)" << std::endl;
+    return true;
+}
+
+bool AsyncModelLoader::uploadPreview(Renderer& renderer, std::chrono::steady_clock::time_point deadline) {
+    size_t capacity = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        capacity = m_pendingCapacity;
+        m_pendingCapacity = 0;
+        while (!m_pendingChunks.empty()) {
+            m_uploadQueue.push_back(std::move(m_pendingChunks.front()));
+            m_pendingChunks.pop_front();
+        }
+    }
+    
+    if (capacity > 0) {
+        m_previewStarted = renderer.beginProgressiveModel(capacity);
+    }
+    
+    // Sin vista previa (archivo pequeño o backend por CPU) solo hay que esperar al hilo
+    if (!m_previewStarted) {
+        m_uploadQueue.clear();
+        return true;
+    }
+    
+    while (!m_uploadQueue.empty()) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        
+        const std::vector<Triangle>& chunk = m_uploadQueue.front();
+        size_t count = std::min(kUploadChunkTriangles, chunk.size() - m_uploadOffset);
+        renderer.appendProgressiveTriangles(chunk.data() + m_uploadOffset, count);
+        m_uploadOffset += count;
+        
+        if (m_uploadOffset >= chunk.size()) {
+            m_uploadQueue.pop_front();
+            m_uploadOffset = 0;
+        }
+    }
+    
+    return true;
+}
+
+float AsyncModelLoader::getProgress() const {
+    if (m_state == AsyncLoadState::Uploading) {
+        return m_uploadProgress;
+    }
+    
+    if (m_state == AsyncLoadState::Finished) {
+        return 1.0f;
+    }
+    
+    uint64_t total = m_totalBytes.load();
+    return total > 0 ? (float)m_bytesRead.load() / (float)total : 0.0f;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "model.h"
+#include "stl_loader.h"
+
+class Renderer;
+
+// Fases de una carga asíncrona vistas desde el hilo de render
+enum class AsyncLoadState {
+    Idle,
+    Loading,      // El hilo de trabajo está leyendo el archivo
+    Uploading,    // El modelo está leído y se sube al VBO por bloques
+    Finished,
+    Failed,
+    Cancelled
+};
+
+// Carga de modelos STL en un hilo de trabajo para no congelar la interfaz.
+// El hilo solo lee y transforma la malla; todo lo que toca OpenGL (vista previa
+// progresiva y subida final) se hace en update(), desde el hilo de render y con
+// un presupuesto de tiempo por frame
+class AsyncModelLoader {
+public:
+    AsyncModelLoader();
+    ~AsyncModelLoader();
+    
+    // Empieza a cargar el archivo (cancela y espera a la carga anterior si la hay)
+    bool start(const std::string& filename);
+    
+    // Pide al hilo que pare; el estado pasa a Cancelled en el siguiente update()
+    void cancel();
+    
+    // Hilo de render: sube lo que haya listo sin pasar de budgetMs. Devuelve true
+    // en la llamada en la que la carga termina (con éxito, error o cancelación)
+    bool update(Renderer& renderer, double budgetMs);
+    
+    AsyncLoadState getState() const { return m_state; }
+    bool isBusy() const { return m_state == AsyncLoadState::Loading || m_state == AsyncLoadState::Uploading; }
+    const std::string& getFilename() const { return m_filename; }
+    
+    // Progreso real de la lectura
+    uint64_t getBytesRead() const { return m_bytesRead.load(); }
+    uint64_t getTotalBytes() const { return m_totalBytes.load(); }
+    size_t getTrianglesParsed() const { return m_trianglesParsed.load(); }
+    
+    // Fracción de la fase actual (lectura o subida) entre 0 y 1
+    float getProgress() const;
+
+private:
+    // Resultado del hilo de trabajo
+    enum WorkerResult { Running, Succeeded, Error, Aborted };
+    
+    void run();
+    void join();
+    bool uploadPreview(Renderer& renderer, std::chrono::steady_clock::time_point deadline);
+    
+    std::thread m_thread;
+    StlLoader m_loader;
+    std::string m_filename;
+    AsyncLoadState m_state;
+    float m_uploadProgress;
+    
+    // Compartido con el hilo de trabajo
+    std::atomic<bool> m_cancel;
+    std::atomic<int> m_result;
+    std::atomic<uint64_t> m_bytesRead;
+    std::atomic<uint64_t> m_totalBytes;
+    std::atomic<size_t> m_trianglesParsed;
+    
+    // Bloques de vista previa pendientes de subir (protegidos por m_mutex)
+    std::mutex m_mutex;
+    size_t m_pendingCapacity;
+    std::deque<std::vector<Triangle>> m_pendingChunks;
+    
+    // Bloques ya recogidos por el hilo de render y triángulos subidos del primero
+    std::deque<std::vector<Triangle>> m_uploadQueue;
+    size_t m_uploadOffset;
+    bool m_previewStarted;
+};
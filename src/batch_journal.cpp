@@ -0,0 +1,95 @@
+#include "batch_journal.h"
+#include <iostream>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+const char* BatchJournal::kFileName = ".stlrender_journal.tsv";
+
+BatchJournal::BatchJournal(const std::string& path)
+    : m_path(path)
+{
+}
+
+BatchJournal::~BatchJournal() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_file.is_open()) {
+        m_file.close();
+    }
+}
+
+bool BatchJournal::open(bool resume) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_completed.clear();
+    
+    bool endsWithNewline = true;
+    if (resume) {
+        std::ifstream previous(m_path, std::ios::binary);
+        std::string line;
+        size_t failed = 0;
+        while (std::getline(previous, line)) {
+            // estado \t entrada \t salida; sin '\n' final la línea quedó a medias
+            if (previous.eof()) {
+                endsWithNewline = false;
+                break;
+            }
+            size_t first = line.find('\t');
+            size_t second = first == std::string::npos ? std::string::npos : line.find('\t', first + 1);
+            if (second == std::string::npos) {
+                continue;
+            }
+            
+            std::string status = line.substr(0, first);
+            std::string files = line.substr(first + 1);
+            if (status == "ok") {
+                m_completed.insert(files);
+            } else if (status == "fail") {
+                failed++;
+            }
+        }
+        
+        std::cout << "Reanudando lote: " << m_completed.size() << " archivos ya terminados, "
+                  << failed << " fallidos se reintentan (" << m_path << ")" << std::endl;
+    }
+    
+    m_file.open(m_path, resume ? (std::ios::out | std::ios::app) : (std::ios::out | std::ios::trunc));
+    if (!m_file.is_open()) {
+        std::cerr << "Error: No se pudo abrir el diario del lote: " << m_path << std::endl;
+        return false;
+    }
+    
+    // Cerrar la línea cortada para que la siguiente empiece limpia
+    if (!endsWithNewline) {
+        m_file << '\n';
+        m_file.flush();
+    }
+    return true;
+}
+
+bool BatchJournal::isCompleted(const std::string& inputFile, const std::string& outputFile) const {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_completed.count(inputFile + '\t' + outputFile) == 0) {
+            return false;
+        }
+    }
+    
+    std::error_code ec;
+    return fs::exists(outputFile, ec);
+}
+
+void BatchJournal::record(const std::string& inputFile, const std::string& outputFile, bool success) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_file.is_open()) {
+        return;
+    }
+    
+    // Volcado inmediato: lo que el proceso no llegó a escribir se rehace al reanudar
+    m_file << (success ? "ok" : "fail") << '\t' << inputFile << '\t' << outputFile << '\n';
+    m_file.flush();
+}
+
+size_t BatchJournal::getCompletedCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_completed.size();
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string>
+#include <fstream>
+#include <mutex>
+#include <unordered_set>
+
+// Diario de un lote: una línea por archivo terminado ("ok" o "fail", entrada, salida),
+// añadida y volcada al momento. Si el proceso muere (cierre forzoso, falta de memoria,
+// máquina reclamada), --resume lee el diario y el lote sigue donde se quedó. Una última
+// línea cortada a medias no cuenta. Seguro desde varios hilos
+class BatchJournal {
+public:
+    explicit BatchJournal(const std::string& path);
+    ~BatchJournal();
+    
+    // resume = true: conserva lo anotado y sigue añadiendo; false: empieza un diario nuevo
+    bool open(bool resume);
+    
+    // Terminado en una ejecución anterior y con la imagen todavía en su sitio
+    bool isCompleted(const std::string& inputFile, const std::string& outputFile) const;
+    
+    void record(const std::string& inputFile, const std::string& outputFile, bool success);
+    
+    size_t getCompletedCount() const;
+    const std::string& getPath() const { return m_path; }
+    
+    static const char* kFileName;
+
+private:
+    std::string m_path;
+    std::ofstream m_file;
+    
+    mutable std::mutex m_mutex;
+    std::unordered_set<std::string> m_completed;   // "entrada\tsalida" de las líneas "ok"
+};
@@ -0,0 +1,567 @@
+#include "batch_pipeline.h"
+#include "renderer.h"
+#include "stl_loader.h"
+#include "render_cache.h"
+#include <iostream>
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+// Intervalo entre líneas de progreso del lote
+const double kReportIntervalSeconds = 1.0;
+
+// Bytes por triángulo en cada etapa: la malla decodificada (Triangle), la copia intercalada
+// que se sube y el VBO (en RAM con llvmpipe/OSMesa), 6 floats por vértice cada una
+const uint64_t kMeshBytesPerTriangle = sizeof(Triangle) + 2 * 3 * 6 * sizeof(float);
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Reparte los núcleos libres (uno queda para el hilo de OpenGL) entre carga y codificación
+void resolveThreadCounts(const BatchPipelineSettings& settings, int& loaders, int& encoders) {
+    int cores = static_cast<int>(std::thread::hardware_concurrency());
+    int workers = std::max(2, cores - 1);
+    
+    loaders = settings.loaderThreads > 0 ? settings.loaderThreads : std::max(1, workers / 2);
+    encoders = settings.encoderThreads > 0 ? settings.encoderThreads : std::max(1, workers - loaders);
+}
+
+} // namespace
+
+BatchPipeline::BatchPipeline(Renderer& renderer, const BatchPipelineSettings& settings)
+    : m_renderer(renderer)
+    , m_settings(settings)
+    , m_loaderThreads(1)
+    , m_encoderThreads(1)
+    , m_cache(nullptr)
+    , m_cacheHits(0)
+    , m_expectedFiles(0)
+    , m_submitted(0)
+    , m_nextJobId(0)
+    , m_inputQueue(settings.inputQueueDepth > 0 ? settings.inputQueueDepth : 1,
+                   settings.scheduleBySize ? static_cast<uint64_t>(std::max(0, settings.smallJobTriangles)) : 0)
+    , m_activeLoaders(0)
+    , m_loadQueue(settings.queueDepth > 0 ? settings.queueDepth : 1)
+    , m_memoryBudget(static_cast<uint64_t>(std::max(0, settings.memoryBudgetMB)) * 1024 * 1024)
+    , m_backend(renderer.getBackend())
+    , m_provider(renderer.getContextProvider())
+    , m_processed(0)
+    , m_encodeQueue(settings.queueDepth > 0 ? settings.queueDepth : 1)
+    , m_saved(0)
+{
+    resolveThreadCounts(settings, m_loaderThreads, m_encoderThreads);
+}
+
+BatchPipeline::~BatchPipeline() {
+    m_memoryBudget.close();
+    m_inputQueue.close();
+    m_loadQueue.close();
+    m_encodeQueue.close();
+    joinThreads();
+}
+
+int BatchPipeline::run(const std::vector<std::pair<std::string, std::string>>& files) {
+    if (files.empty()) {
+        return 0;
+    }
+    
+    m_expectedFiles = files.size();
+    return run([&files](BatchPipeline& pipeline) {
+        for (const auto& file : files) {
+            if (!pipeline.submit(file.first, file.second)) {
+                break;
+            }
+        }
+    });
+}
+
+void BatchPipeline::setRenderCache(RenderCache* cache, const std::string& parameters) {
+    m_cache = cache;
+    m_cacheParameters = parameters;
+}
+
+bool BatchPipeline::submit(const std::string& inputFile, const std::string& outputFile) {
+    BatchJob job;
+    job.id = m_nextJobId++;
+    job.inputFile = inputFile;
+    job.outputFile = outputFile;
+    job.settings = m_settings.render;
+    return submit(std::move(job));
+}
+
+bool BatchPipeline::submit(BatchJob job) {
+    job.submitted = std::chrono::steady_clock::now();
+    
+    // Solo se lee la cabecera; sin orden por tamaño todos cuestan igual y la cola es FIFO
+    if (m_settings.scheduleBySize && job.cost == 0) {
+        job.cost = StlLoader::estimateTriangles(job.inputFile);
+    }
+    uint64_t cost = m_settings.scheduleBySize ? job.cost : 0;
+    
+    // Bloquea si los cargadores van por detrás (el escáner no se adelanta sin límite)
+    if (!m_inputQueue.push(std::move(job), cost)) {
+        return false;
+    }
+    m_submitted++;
+    return true;
+}
+
+int BatchPipeline::run(const std::function<void(BatchPipeline&)>& producer) {
+    // Sin lista previa no se sabe cuántos archivos habrá: se dimensiona para un lote grande
+    int limit = m_expectedFiles > 0 ? static_cast<int>(std::min<size_t>(m_expectedFiles, 1 << 20)) : (1 << 20);
+    
+    // Más contextos solo si el principal no es una ventana: todos deben salir de la misma
+    // biblioteca (EGL/OSMesa) para compartir los punteros de función de GLAD
+    int renderThreads = std::max(1, std::min(m_settings.renderThreads, limit));
+    if (renderThreads > 1 && m_backend == RenderBackend::OpenGL && m_provider == HeadlessProvider::Glfw) {
+        std::cout << "Renderers adicionales desactivados: el contexto principal es una ventana GLFW" << std::endl;
+        renderThreads = 1;
+    }
+    
+    m_loaderThreads = std::min(m_loaderThreads, limit);
+    std::cout << "Lote en paralelo: " << m_loaderThreads << " hilos de carga, "
+              << renderThreads << " de render, " << m_encoderThreads << " de codificación, colas de "
+              << m_loadQueue.capacity() << std::endl;
+    if (m_settings.scheduleBySize) {
+        std::cout << "Orden por tamaño: los modelos más grandes primero";
+        if (m_inputQueue.hasSmallLane()) {
+            std::cout << ", carril aparte para menos de " << m_settings.smallJobTriangles << " triángulos";
+        }
+        std::cout << std::endl;
+    }
+    if (m_memoryBudget.getLimit() > 0) {
+        std::cout << "Presupuesto de memoria para mallas: " << m_settings.memoryBudgetMB << " MB" << std::endl;
+    }
+    
+    m_workers.resize(renderThreads);
+    m_workers[0].renderer = &m_renderer;
+    setupWorker(m_workers[0]);
+    if (m_workers[0].tilesPerAtlas > 0) {
+        std::cout << "Renderizando en atlas de " << m_workers[0].atlasColumns << "x" << m_workers[0].atlasRows
+                  << " miniaturas de " << m_settings.render.width << "x" << m_settings.render.height << std::endl;
+    }
+    
+    // El productor (lista o escáner) alimenta la cola de entrada mientras se renderiza
+    m_producer = std::thread([this, &producer]() {
+        producer(*this);
+        m_inputQueue.close();
+    });
+    
+    m_activeLoaders = m_loaderThreads;
+    for (int i = 0; i < m_loaderThreads; ++i) {
+        m_loaders.emplace_back(&BatchPipeline::loaderLoop, this, i);
+    }
+    for (int i = 0; i < m_encoderThreads; ++i) {
+        m_encoders.emplace_back(&BatchPipeline::encoderLoop, this);
+    }
+    
+    for (size_t i = 1; i < m_workers.size(); ++i) {
+        m_renderThreads.emplace_back(&BatchPipeline::renderWorkerLoop, this, i);
+    }
+    
+    m_lastReport = std::chrono::steady_clock::now();
+    renderStage(m_workers[0], true);
+    
+    for (auto& thread : m_renderThreads) {
+        thread.join();
+    }
+    m_renderThreads.clear();
+    
+    // Sin más imágenes: los codificadores vacían la cola y terminan
+    m_encodeQueue.close();
+    joinThreads();
+    
+    reportProgress(true);
+    printSummary();
+    
+    return m_saved.load();
+}
+
+void BatchPipeline::joinThreads() {
+    if (m_producer.joinable()) {
+        m_producer.join();
+    }
+    for (auto& thread : m_renderThreads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    for (auto& thread : m_loaders) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    for (auto& thread : m_encoders) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    m_renderThreads.clear();
+    m_loaders.clear();
+    m_encoders.clear();
+}
+
+void BatchPipeline::loaderLoop(int index) {
+    StlLoader loader;
+    
+    // El primer cargador atiende antes el carril pequeño; si es el único, alterna carriles
+    bool preferSmall = index == 0 && m_inputQueue.hasSmallLane();
+    bool alternate = preferSmall && m_loaderThreads == 1;
+    
+    BatchJob job;
+    while (m_inputQueue.pop(job, preferSmall)) {
+        if (alternate) {
+            preferSmall = !preferSmall;
+        }
+        
+        LoadedModel item;
+        item.job = std::move(job);
+        
+        // Espera a que la malla quepa en el presupuesto antes de leerla
+        auto start = std::chrono::steady_clock::now();
+        uint64_t triangles = item.job.cost > 0 ? item.job.cost : StlLoader::estimateTriangles(item.job.inputFile);
+        item.reservedBytes = triangles * kMeshBytesPerTriangle;
+        if (!m_memoryBudget.acquire(item.reservedBytes)) {
+            break;
+        }
+        
+        // El sello se toma justo antes de leer (el hash deja el archivo en la caché del
+        // sistema para la carga) y se descarta si el archivo cambió mientras se cargaba
+        if (m_settings.stampSources) {
+            item.job.source = RenderManifest::stampFile(item.job.inputFile);
+        }
+        item.loaded = loader.loadFile(item.job.inputFile);
+        if (item.loaded && item.job.source.valid && !RenderManifest::isStampCurrent(item.job.inputFile, item.job.source)) {
+            item.job.source.valid = false;
+        }
+        if (item.loaded) {
+            item.model = loader.releaseModel();
+            
+            // Pieza ya renderizada con otro nombre: solo el hash y un enlace
+            if (m_cache) {
+                const std::string& parameters = item.job.cacheParameters.empty() ? m_cacheParameters : item.job.cacheParameters;
+                item.cacheKey = RenderCache::makeKey(item.model, parameters);
+                if (m_cache->fetch(item.cacheKey, item.job.outputFile)) {
+                    item.timings.loadMs = millisecondsSince(start);
+                    m_processed++;
+                    m_saved++;
+                    m_cacheHits++;
+                    std::cout << "✓ Imagen de la caché: " << item.job.outputFile << std::endl;
+                    reportResult(item.job, item.timings, true, "", true);
+                    item.model = Model();
+                    m_memoryBudget.release(item.reservedBytes);
+                    continue;
+                }
+            }
+        }
+        item.timings.loadMs = millisecondsSince(start);
+        
+        // Sin malla no hay nada que retener hasta el render
+        if (!item.loaded) {
+            m_memoryBudget.release(item.reservedBytes);
+            item.reservedBytes = 0;
+        }
+        
+        // Bloquea si el render va por detrás: como mucho queueDepth modelos en memoria
+        uint64_t reserved = item.reservedBytes;
+        if (!m_loadQueue.push(std::move(item))) {
+            m_memoryBudget.release(reserved);
+            break;
+        }
+    }
+    
+    // El último cargador en terminar avisa al render de que no llegarán más modelos
+    if (--m_activeLoaders == 0) {
+        m_loadQueue.close();
+    }
+}
+
+void BatchPipeline::encoderLoop() {
+    EncodeTask task;
+    while (m_encodeQueue.pop(task)) {
+        auto start = std::chrono::steady_clock::now();
+        const std::string& outputFile = task.job.outputFile;
+        
+        bool result = Renderer::writePng(outputFile, task.pixels.data(), task.width, task.height, task.channels);
+        if (!result) {
+            std::cerr << "ERROR: stbi_write_png falló al guardar la imagen: " << outputFile << std::endl;
+        } else {
+            m_saved++;
+            std::cout << "✓ Imagen guardada: " << outputFile << std::endl;
+            if (m_cache && !task.cacheKey.empty()) {
+                m_cache->store(task.cacheKey, outputFile);
+            }
+        }
+        task.timings.encodeMs = millisecondsSince(start);
+        reportResult(task.job, task.timings, result, result ? "" : "no se pudo escribir el PNG");
+    }
+}
+
+void BatchPipeline::renderWorkerLoop(size_t index) {
+    // Renderer y contexto propios, creados y usados solo en este hilo
+    Renderer renderer;
+    renderer.setBackend(m_backend);
+    renderer.setHeadlessProvider(m_provider);
+    renderer.setWindowFallback(false);
+    if (!renderer.initializeHeadless(m_settings.render.width, m_settings.render.height)) {
+        // Los demás renderers siguen sacando modelos de la cola
+        std::cerr << "Renderer " << index << " del lote no disponible" << std::endl;
+        return;
+    }
+    renderer.setOutputSamples(m_settings.render.samples);
+    
+    RenderWorker& worker = m_workers[index];
+    worker.renderer = &renderer;
+    setupWorker(worker);
+    renderStage(worker, false);
+    worker.renderer = nullptr;
+}
+
+void BatchPipeline::setupWorker(RenderWorker& worker) {
+    Renderer& renderer = *worker.renderer;
+    
+    // Atlas: varias miniaturas por framebuffer y una sola lectura (no disponible por CPU)
+    int maxSize = renderer.getMaxFramebufferSize();
+    if (m_settings.atlasColumns > 1 && m_expectedFiles != 1 && maxSize > 0 && !renderer.needsTiledOutput()) {
+        worker.atlasColumns = std::min(m_settings.atlasColumns, maxSize / m_settings.render.width);
+        worker.atlasRows = std::min(m_settings.atlasColumns, maxSize / m_settings.render.height);
+        worker.tilesPerAtlas = worker.atlasColumns * worker.atlasRows;
+    }
+    if (worker.tilesPerAtlas <= 1) {
+        worker.tilesPerAtlas = 0;
+    }
+}
+
+void BatchPipeline::renderStage(RenderWorker& worker, bool reportsProgress) {
+    Renderer& renderer = *worker.renderer;
+    
+    LoadedModel item;
+    while (m_loadQueue.pop(item)) {
+        m_processed++;
+        
+        if (!item.loaded) {
+            std::cerr << "✗ Error al cargar el modelo: " << item.job.inputFile << std::endl;
+            reportResult(item.job, item.timings, false, "no se pudo cargar el modelo");
+            continue;
+        }
+        
+        // Un render suelto cambia la proyección y su framebuffer puede expulsar el atlas del
+        // pool: las miniaturas ya dibujadas se leen antes
+        bool useAtlas = worker.tilesPerAtlas > 0 && fitsAtlas(item.job.settings);
+        if (!useAtlas) {
+            flushAtlas(worker);
+        }
+        
+        auto start = std::chrono::steady_clock::now();
+        uploadModel(worker, item);
+        bool transparent = item.job.settings.transparentBackground;
+        
+        if (useAtlas) {
+            // Un atlas nuevo cuando el anterior se ha leído
+            if (worker.atlasUsed == 0 && !renderer.beginAtlas(m_settings.render.width, m_settings.render.height,
+                                                             worker.atlasColumns, worker.atlasRows, transparent)) {
+                std::cerr << "✗ Error al preparar el atlas: " << item.job.inputFile << std::endl;
+                item.timings.renderMs = millisecondsSince(start);
+                reportResult(item.job, item.timings, false, "no se pudo preparar el atlas");
+            } else {
+                bool rendered = renderer.renderAtlasTile(worker.atlasUsed);
+                item.timings.renderMs = millisecondsSince(start);
+                if (rendered) {
+                    AtlasTile tile;
+                    tile.index = worker.atlasUsed;
+                    tile.job = std::move(item.job);
+                    tile.timings = item.timings;
+                    tile.cacheKey = item.cacheKey;
+                    worker.atlasTiles.push_back(std::move(tile));
+                } else {
+                    reportResult(item.job, item.timings, false, "fallo del renderer");
+                }
+                if (++worker.atlasUsed == worker.tilesPerAtlas) {
+                    flushAtlas(worker);
+                }
+            }
+        } else if (renderer.needsTiledOutput()) {
+            // Pósters: se escriben por bandas desde el propio hilo de OpenGL
+            bool saved = renderer.renderToFile(item.job.outputFile, transparent);
+            if (saved) {
+                m_saved++;
+                if (m_cache && !item.cacheKey.empty()) {
+                    m_cache->store(item.cacheKey, item.job.outputFile);
+                }
+            }
+            item.timings.renderMs = millisecondsSince(start);
+            reportResult(item.job, item.timings, saved, saved ? "" : "no se pudo escribir el PNG");
+        } else {
+            EncodeTask task;
+            task.cacheKey = item.cacheKey;
+            task.width = renderer.getWidth();
+            task.height = renderer.getHeight();
+            bool rendered = renderer.renderToBuffer(task.pixels, task.channels, transparent);
+            item.timings.renderMs = millisecondsSince(start);
+            if (rendered) {
+                task.job = std::move(item.job);
+                task.timings = item.timings;
+                m_encodeQueue.push(std::move(task));
+            } else {
+                std::cerr << "✗ Error al renderizar: " << item.job.inputFile << std::endl;
+                reportResult(item.job, item.timings, false, "fallo del renderer");
+            }
+        }
+        
+        // La imagen ya está en el atlas o en la cola de codificación: la malla sobra
+        renderer.releaseModelData();
+        m_memoryBudget.release(item.reservedBytes);
+        
+        worker.rendered++;
+        worker.renderMs += millisecondsSince(start);
+        if (reportsProgress) {
+            reportProgress(false);
+        }
+    }
+    
+    // Último atlas a medio llenar
+    flushAtlas(worker);
+}
+
+void BatchPipeline::uploadModel(RenderWorker& worker, LoadedModel& item) {
+    Renderer& renderer = *worker.renderer;
+    
+    const RenderJobSettings& settings = item.job.settings;
+    
+    // Cada trabajo puede traer sus ajustes (tamaño, muestras, colores)
+    renderer.applyJobSettings(settings);
+    
+    // Subida completa en una llamada: en el lote no hay frames que proteger
+    renderer.beginModelUpload(std::move(item.model));
+    renderer.uploadModelChunk(std::numeric_limits<size_t>::max());
+    
+    // Misma cámara que renderSingleFile
+    renderer.centerCamera();
+    renderer.setCameraOrbit(settings.cameraYaw, settings.cameraPitch, settings.cameraDistance);
+}
+
+bool BatchPipeline::fitsAtlas(const RenderJobSettings& settings) const {
+    // Las celdas del atlas tienen el tamaño, el fondo (un solo clear) y las muestras del lote
+    const RenderJobSettings& batch = m_settings.render;
+    return settings.width == batch.width && settings.height == batch.height &&
+           settings.transparentBackground == batch.transparentBackground &&
+           glm::vec3(settings.backgroundColor) == glm::vec3(batch.backgroundColor) &&
+           settings.samples == batch.samples;
+}
+
+void BatchPipeline::flushAtlas(RenderWorker& worker) {
+    if (worker.atlasUsed == 0) {
+        return;
+    }
+    
+    std::vector<int> indices;
+    indices.reserve(worker.atlasTiles.size());
+    for (const auto& tile : worker.atlasTiles) {
+        indices.push_back(tile.index);
+    }
+    
+    // Una lectura para todo el atlas; cada miniatura se comprime en los codificadores
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::vector<unsigned char>> images;
+    bool read = worker.renderer->readAtlasTiles(indices, images);
+    
+    // La lectura se reparte entre las miniaturas del atlas
+    double readMs = millisecondsSince(start) / static_cast<double>(std::max<size_t>(1, worker.atlasTiles.size()));
+    for (auto& tile : worker.atlasTiles) {
+        tile.timings.renderMs += readMs;
+    }
+    
+    if (read) {
+        for (size_t i = 0; i < images.size(); ++i) {
+            EncodeTask task;
+            task.job = std::move(worker.atlasTiles[i].job);
+            task.timings = worker.atlasTiles[i].timings;
+            task.cacheKey = worker.atlasTiles[i].cacheKey;
+            task.pixels = std::move(images[i]);
+            task.width = m_settings.render.width;
+            task.height = m_settings.render.height;
+            task.channels = m_settings.render.transparentBackground ? 4 : 3;
+            m_encodeQueue.push(std::move(task));
+        }
+    } else {
+        std::cerr << "Error al leer el atlas, se omiten " << worker.atlasTiles.size() << " archivos" << std::endl;
+        for (const auto& tile : worker.atlasTiles) {
+            reportResult(tile.job, tile.timings, false, "no se pudo leer el atlas");
+        }
+    }
+    
+    worker.atlasTiles.clear();
+    worker.atlasUsed = 0;
+}
+
+void BatchPipeline::reportResult(const BatchJob& job, BatchTimings timings, bool success, const std::string& error, bool cached) {
+    if (!m_onResult) {
+        return;
+    }
+    
+    // Lo que no se pasó cargando, renderizando o codificando se pasó en una cola
+    timings.totalMs = millisecondsSince(job.submitted);
+    timings.queueMs = std::max(0.0, timings.totalMs - timings.loadMs - timings.renderMs - timings.encodeMs);
+    
+    BatchResult result;
+    result.id = job.id;
+    result.inputFile = job.inputFile;
+    result.outputFile = job.outputFile;
+    result.success = success;
+    result.cached = cached;
+    result.source = job.source;
+    result.error = error;
+    result.timings = timings;
+    m_onResult(result);
+}
+
+void BatchPipeline::reportProgress(bool force) {
+    auto now = std::chrono::steady_clock::now();
+    if (!force && std::chrono::duration<double>(now - m_lastReport).count() < kReportIntervalSeconds) {
+        return;
+    }
+    m_lastReport = now;
+    
+    std::cout << "Lote: " << m_processed.load() << "/" << m_submitted.load() << " renderizados, " << m_saved.load() << " guardados"
+              << " | cola de carga " << m_loadQueue.size() << "/" << m_loadQueue.capacity()
+              << " | cola de codificación " << m_encodeQueue.size() << "/" << m_encodeQueue.capacity() << std::endl;
+}
+
+void BatchPipeline::printSummary() const {
+    BoundedQueueStats load = m_loadQueue.getStats();
+    BoundedQueueStats encode = m_encodeQueue.getStats();
+    
+    // Una cola casi siempre llena indica que la etapa siguiente limita; casi vacía, la anterior
+    std::cout << "Ocupación de las etapas del lote:" << std::endl;
+    std::cout << "  Carga (" << m_loaderThreads << " hilos): cola media " << load.averageOccupancy << "/" << load.capacity
+              << " (máx " << load.peak << "), esperando al render " << load.pushWaitMs << " ms" << std::endl;
+    // Reparto entre renderers: con la cola compartida el más rápido se lleva más modelos
+    double renderMs = 0.0;
+    std::string share;
+    for (const auto& worker : m_workers) {
+        renderMs += worker.renderMs;
+        share += (share.empty() ? "" : "/") + std::to_string(worker.rendered);
+    }
+    
+    std::cout << "  Render (" << m_workers.size() << " contextos, reparto " << share << "): trabajando " << renderMs
+              << " ms, esperando modelos " << load.popWaitMs << " ms, esperando a la codificación " << encode.pushWaitMs << " ms" << std::endl;
+    std::cout << "  Codificación (" << m_encoderThreads << " hilos): cola media " << encode.averageOccupancy << "/" << encode.capacity
+              << " (máx " << encode.peak << "), sin trabajo " << encode.popWaitMs << " ms" << std::endl;
+    
+    // Huella estimada de las mallas cargadas, en cola o en los renderers a la vez
+    MemoryBudgetStats memory = m_memoryBudget.getStats();
+    std::cout << "  Memoria de mallas: pico " << memory.peakBytes / (1024 * 1024) << " MB";
+    if (memory.limitBytes > 0) {
+        std::cout << " de " << memory.limitBytes / (1024 * 1024) << " MB, " << memory.waited << " archivos esperaron "
+                  << memory.waitMs << " ms, " << memory.oversized << " mayores que el presupuesto";
+    }
+    std::cout << std::endl;
+    
+    if (m_cache) {
+        RenderCacheStats cache = m_cache->getStats();
+        std::cout << "  Caché de renders: " << m_cacheHits.load() << " aciertos en este lote, " << cache.entries << " imágenes, "
+                  << cache.bytes / (1024 * 1024) << " MB (" << cache.evicted << " descartadas por tamaño)" << std::endl;
+    }
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include "model.h"
+#include "bounded_queue.h"
+#include "cost_queue.h"
+#include "memory_budget.h"
+#include "render_job_queue.h"
+#include "headless_context.h"
+#include "render_manifest.h"
+
+class Renderer;
+class RenderCache;
+
+// Parámetros de un lote en paralelo
+struct BatchPipelineSettings {
+    RenderJobSettings render;       // Colores, cámara y fondo comunes a todo el lote
+    int atlasColumns = 1;           // Miniaturas por fila del atlas (1 = una imagen por render)
+    int renderThreads = 1;          // Contextos que renderizan a la vez (1 = solo el del hilo que llama)
+    int loaderThreads = 0;          // Hilos que leen STL (0 = según los núcleos)
+    int encoderThreads = 0;         // Hilos que comprimen y escriben PNG (0 = según los núcleos)
+    int queueDepth = 8;             // Capacidad de cada cola entre etapas
+    int inputQueueDepth = 4096;     // Archivos esperando a los cargadores (solo rutas)
+    bool scheduleBySize = true;     // Cargar primero los modelos con más triángulos estimados
+    int smallJobTriangles = 100000; // Por debajo van al carril de trabajos pequeños (0 = sin carril)
+    int memoryBudgetMB = 0;         // Mallas en memoria a la vez (0 = sin límite; el pico se mide igual)
+    bool stampSources = false;      // Sellar cada STL al cargarlo (tamaño, fecha, hash) para el manifiesto
+};
+
+// Un archivo del lote; los que entran con submit(input, output) usan los ajustes del lote
+struct BatchJob {
+    size_t id = 0;                  // Lo elige quien lo envía y vuelve en el resultado
+    std::string inputFile;
+    std::string outputFile;
+    RenderJobSettings settings;
+    std::string cacheParameters;    // Huella de settings para la caché (vacía = la del lote)
+    uint64_t cost = 0;              // Triángulos estimados; submit los calcula si es 0
+    std::chrono::steady_clock::time_point submitted;
+    SourceStamp source;             // Lo rellena el cargador con stampSources
+};
+
+// Tiempo de cada archivo en las etapas, en ms; queue es lo que pasó esperando en las colas
+struct BatchTimings {
+    double queueMs = 0.0;
+    double loadMs = 0.0;
+    double renderMs = 0.0;
+    double encodeMs = 0.0;
+    double totalMs = 0.0;
+};
+
+// Archivo terminado, guardado o fallido
+struct BatchResult {
+    size_t id = 0;
+    std::string inputFile;
+    std::string outputFile;
+    bool success = false;
+    bool cached = false;            // Imagen sacada de la caché, sin renderizar
+    SourceStamp source;             // El STL tal como se leyó (con stampSources)
+    std::string error;
+    BatchTimings timings;
+};
+
+// Lote de renders en tres etapas unidas por colas acotadas:
+//   carga (varios hilos: leer y normalizar el STL) ->
+//   render (el hilo que llama a run con su contexto OpenGL, más renderThreads - 1 hilos
+//           con un Renderer y un contexto sin ventana propios: subir, dibujar y leer) ->
+//   codificación (varios hilos: comprimir y escribir el PNG).
+// Mientras la GPU dibuja un modelo, los siguientes se están leyendo y los anteriores
+// comprimiendo. Todos los renderers sacan modelos de la misma cola, así que el que
+// queda libre toma el siguiente. Con scheduleBySize los cargadores toman primero el
+// archivo pendiente más grande (el orden solo abarca lo que ya está en la cola: si el
+// escaneo de la carpeta encuentra tarde un archivo enorme, también empieza tarde) y el
+// primero de ellos atiende antes un carril de trabajos pequeños
+// en orden de llegada, para que las miniaturas baratas no esperen. Antes de cargar un
+// archivo se reserva su huella estimada en el presupuesto de memoria (malla decodificada,
+// copia para la subida y VBO) y se devuelve cuando el renderer suelta la malla; así
+// varios escaneos enormes no se cargan a la vez. Un objeto por lote
+class BatchPipeline {
+public:
+    BatchPipeline(Renderer& renderer, const BatchPipelineSettings& settings);
+    ~BatchPipeline();
+    
+    // Procesa los pares (STL, PNG) y devuelve cuántas imágenes se guardaron
+    int run(const std::vector<std::pair<std::string, std::string>>& files);
+    
+    // Igual, pero los archivos llegan mientras se renderiza: producer corre en su propio
+    // hilo y entrega cada par con submit (p. ej. un escaneo de carpetas en curso)
+    int run(const std::function<void(BatchPipeline&)>& producer);
+    
+    // Seguro desde varios hilos; bloquea si la cola de entrada está llena
+    bool submit(const std::string& inputFile, const std::string& outputFile);
+    
+    // Con ajustes propios (cámara, colores, tamaño); el atlas solo agrupa los que
+    // tienen el tamaño, el fondo y las muestras del lote
+    bool submit(BatchJob job);
+    
+    // Ajustes que se copian en los trabajos enviados con submit(input, output)
+    const RenderJobSettings& getDefaultSettings() const { return m_settings.render; }
+    
+    // Aviso por cada archivo terminado (guardado o fallido), desde los hilos del lote
+    using ResultCallback = std::function<void(const BatchResult& result)>;
+    void setResultCallback(const ResultCallback& callback) { m_onResult = callback; }
+    
+    // Los cargadores buscan cada modelo en la caché antes de mandarlo a renderizar;
+    // parameters es la huella de los ajustes de render (ver RenderManifest::describeSettings)
+    void setRenderCache(RenderCache* cache, const std::string& parameters);
+
+private:
+    struct LoadedModel {
+        BatchJob job;
+        BatchTimings timings;
+        std::string cacheKey;
+        Model model;
+        bool loaded = false;
+        uint64_t reservedBytes = 0;     // En m_memoryBudget hasta que se suelta la malla
+    };
+    
+    struct EncodeTask {
+        BatchJob job;
+        BatchTimings timings;
+        std::string cacheKey;
+        std::vector<unsigned char> pixels;
+        int width = 0;
+        int height = 0;
+        int channels = 0;
+    };
+    
+    struct AtlasTile {
+        int index = 0;
+        BatchJob job;
+        BatchTimings timings;
+        std::string cacheKey;
+    };
+    
+    // Estado de cada renderer; solo lo toca su hilo
+    struct RenderWorker {
+        Renderer* renderer = nullptr;
+        int tilesPerAtlas = 0;
+        int atlasColumns = 0;
+        int atlasRows = 0;
+        std::vector<AtlasTile> atlasTiles;
+        int atlasUsed = 0;
+        size_t rendered = 0;
+        double renderMs = 0.0;
+    };
+    
+    void loaderLoop(int index);
+    void encoderLoop();
+    void renderWorkerLoop(size_t index);
+    void setupWorker(RenderWorker& worker);
+    void renderStage(RenderWorker& worker, bool reportsProgress);
+    void uploadModel(RenderWorker& worker, LoadedModel& item);
+    bool fitsAtlas(const RenderJobSettings& settings) const;
+    void flushAtlas(RenderWorker& worker);
+    void reportResult(const BatchJob& job, BatchTimings timings, bool success, const std::string& error, bool cached = false);
+    void reportProgress(bool force);
+    void printSummary() const;
+    void joinThreads();
+    
+    Renderer& m_renderer;
+    BatchPipelineSettings m_settings;
+    int m_loaderThreads;
+    int m_encoderThreads;
+    ResultCallback m_onResult;
+    RenderCache* m_cache;
+    std::string m_cacheParameters;
+    std::atomic<int> m_cacheHits;
+    
+    // Entrada y etapa de carga
+    size_t m_expectedFiles;         // 0 si los archivos llegan en streaming
+    std::atomic<size_t> m_submitted;
+    std::atomic<size_t> m_nextJobId;    // Para los trabajos enviados sin id
+    std::thread m_producer;
+    CostQueue<BatchJob> m_inputQueue;
+    std::atomic<int> m_activeLoaders;
+    std::vector<std::thread> m_loaders;
+    BoundedQueue<LoadedModel> m_loadQueue;
+    MemoryBudget m_memoryBudget;
+    
+    // Etapa de render: el primer worker usa el renderer del hilo que llama
+    RenderBackend m_backend;
+    HeadlessProvider m_provider;
+    std::vector<RenderWorker> m_workers;
+    std::vector<std::thread> m_renderThreads;
+    std::atomic<size_t> m_processed;
+    std::chrono::steady_clock::time_point m_lastReport;
+    
+    // Etapa de codificación
+    std::vector<std::thread> m_encoders;
+    BoundedQueue<EncodeTask> m_encodeQueue;
+    std::atomic<int> m_saved;
+};
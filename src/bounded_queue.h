@@ -0,0 +1,142 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+
+// Ocupación de una cola durante el lote, para ver qué etapa limita
+struct BoundedQueueStats {
+    size_t capacity = 0;
+    size_t peak = 0;
+    double averageOccupancy = 0.0;  // Elementos en cola de media al sacar cada uno
+    double pushWaitMs = 0.0;        // Tiempo que los productores esperaron con la cola llena
+    double popWaitMs = 0.0;         // Tiempo que los consumidores esperaron con la cola vacía
+};
+
+// Contadores de ocupación y espera compartidos por las colas del lote. No bloquea:
+// quien lo usa lo protege con el mismo mutex que la cola
+class QueueStatsTracker {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    void addPushWait(Clock::time_point start) { m_pushWaitMs += elapsedMs(start); }
+    void addPopWait(Clock::time_point start) { m_popWaitMs += elapsedMs(start); }
+    
+    // Tamaño de la cola justo después de meter un elemento
+    void recordPush(size_t size) { m_peak = std::max(m_peak, size); }
+    
+    // Tamaño de la cola justo antes de sacar un elemento
+    void recordPop(size_t size) {
+        m_occupancySum += size;
+        m_pops++;
+    }
+    
+    BoundedQueueStats snapshot(size_t capacity) const {
+        BoundedQueueStats stats;
+        stats.capacity = capacity;
+        stats.peak = m_peak;
+        stats.averageOccupancy = m_pops > 0 ? (double)m_occupancySum / (double)m_pops : 0.0;
+        stats.pushWaitMs = m_pushWaitMs;
+        stats.popWaitMs = m_popWaitMs;
+        return stats;
+    }
+
+private:
+    static double elapsedMs(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+    
+    size_t m_peak = 0;
+    size_t m_occupancySum = 0;
+    size_t m_pops = 0;
+    double m_pushWaitMs = 0.0;
+    double m_popWaitMs = 0.0;
+};
+
+// Cola con capacidad fija entre etapas del lote: push bloquea si está llena (así la
+// memoria queda acotada) y pop bloquea si está vacía. Tras close() los productores
+// fallan y los consumidores vacían lo que queda antes de recibir false
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity)
+        : m_capacity(std::max<size_t>(capacity, 1))
+        , m_closed(false)
+    {
+    }
+    
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_items.size() >= m_capacity && !m_closed) {
+            auto start = QueueStatsTracker::Clock::now();
+            m_notFull.wait(lock, [this]() { return m_items.size() < m_capacity || m_closed; });
+            m_stats.addPushWait(start);
+        }
+        
+        if (m_closed) {
+            return false;
+        }
+        
+        m_items.push_back(std::move(item));
+        m_stats.recordPush(m_items.size());
+        lock.unlock();
+        m_notEmpty.notify_one();
+        return true;
+    }
+    
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_items.empty() && !m_closed) {
+            auto start = QueueStatsTracker::Clock::now();
+            m_notEmpty.wait(lock, [this]() { return !m_items.empty() || m_closed; });
+            m_stats.addPopWait(start);
+        }
+        
+        if (m_items.empty()) {
+            return false;
+        }
+        
+        m_stats.recordPop(m_items.size());
+        
+        item = std::move(m_items.front());
+        m_items.pop_front();
+        lock.unlock();
+        m_notFull.notify_one();
+        return true;
+    }
+    
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+        }
+        m_notEmpty.notify_all();
+        m_notFull.notify_all();
+    }
+    
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_items.size();
+    }
+    
+    size_t capacity() const { return m_capacity; }
+    
+    BoundedQueueStats getStats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats.snapshot(m_capacity);
+    }
+
+private:
+    const size_t m_capacity;
+    std::deque<T> m_items;
+    bool m_closed;
+    
+    mutable std::mutex m_mutex;
+    std::condition_variable m_notFull;
+    std::condition_variable m_notEmpty;
+    
+    // Estadísticas de ocupación
+    QueueStatsTracker m_stats;
+};
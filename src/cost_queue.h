@@ -0,0 +1,135 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include "bounded_queue.h"
+
+// Cola de entrada con capacidad fija como BoundedQueue, pero ordenada por coste estimado:
+// pop entrega el trabajo pendiente más caro (el más largo primero). Solo ordena lo que
+// ya se ha metido: si el productor descubre un trabajo enorme tarde (escaneo de carpeta
+// en streaming), ese trabajo empieza tarde igualmente. Los trabajos con coste menor que
+// smallCost van a un carril aparte en orden de llegada; quien llama a pop con preferSmall
+// lo atiende antes que a los grandes, para que las miniaturas baratas no esperen detrás
+// de escaneos enormes. Con smallCost = 0 no hay carril pequeño
+template <typename T>
+class CostQueue {
+public:
+    CostQueue(size_t capacity, uint64_t smallCost)
+        : m_capacity(std::max<size_t>(capacity, 1))
+        , m_smallCost(smallCost)
+        , m_sequence(0)
+        , m_closed(false)
+    {
+    }
+    
+    bool push(T item, uint64_t cost) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (sizeLocked() >= m_capacity && !m_closed) {
+            auto start = QueueStatsTracker::Clock::now();
+            m_notFull.wait(lock, [this]() { return sizeLocked() < m_capacity || m_closed; });
+            m_stats.addPushWait(start);
+        }
+        
+        if (m_closed) {
+            return false;
+        }
+        
+        if (cost < m_smallCost) {
+            m_small.push_back(std::move(item));
+        } else {
+            // A igual coste, en orden de llegada
+            m_large.push_back(Entry{ cost, m_sequence++, std::move(item) });
+            std::push_heap(m_large.begin(), m_large.end(), compareEntries);
+        }
+        m_stats.recordPush(sizeLocked());
+        lock.unlock();
+        m_notEmpty.notify_one();
+        return true;
+    }
+    
+    // Si el carril preferido está vacío se sirve del otro, así ningún consumidor se queda parado
+    bool pop(T& item, bool preferSmall) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (sizeLocked() == 0 && !m_closed) {
+            auto start = QueueStatsTracker::Clock::now();
+            m_notEmpty.wait(lock, [this]() { return sizeLocked() > 0 || m_closed; });
+            m_stats.addPopWait(start);
+        }
+        
+        if (sizeLocked() == 0) {
+            return false;
+        }
+        
+        m_stats.recordPop(sizeLocked());
+        
+        if (!m_small.empty() && (preferSmall || m_large.empty())) {
+            item = std::move(m_small.front());
+            m_small.pop_front();
+        } else {
+            std::pop_heap(m_large.begin(), m_large.end(), compareEntries);
+            item = std::move(m_large.back().item);
+            m_large.pop_back();
+        }
+        lock.unlock();
+        m_notFull.notify_one();
+        return true;
+    }
+    
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+        }
+        m_notEmpty.notify_all();
+        m_notFull.notify_all();
+    }
+    
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return sizeLocked();
+    }
+    
+    size_t capacity() const { return m_capacity; }
+    bool hasSmallLane() const { return m_smallCost > 0; }
+    
+    BoundedQueueStats getStats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats.snapshot(m_capacity);
+    }
+
+private:
+    struct Entry {
+        uint64_t cost;
+        uint64_t sequence;
+        T item;
+    };
+    
+    // Montículo de máximos: arriba el más caro y, a igual coste, el más antiguo
+    static bool compareEntries(const Entry& a, const Entry& b) {
+        if (a.cost != b.cost) {
+            return a.cost < b.cost;
+        }
+        return a.sequence > b.sequence;
+    }
+    
+    size_t sizeLocked() const { return m_small.size() + m_large.size(); }
+    
+    const size_t m_capacity;
+    const uint64_t m_smallCost;
+    std::deque<T> m_small;
+    std::vector<Entry> m_large;
+    uint64_t m_sequence;
+    bool m_closed;
+    
+    mutable std::mutex m_mutex;
+    std::condition_variable m_notFull;
+    std::condition_variable m_notEmpty;
+    
+    // Estadísticas de ocupación
+    QueueStatsTracker m_stats;
+};
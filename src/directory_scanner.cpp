@@ -0,0 +1,234 @@
+#include "directory_scanner.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cctype>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Listar carpetas en red o en discos lentos es sobre todo esperar: más hilos que núcleos
+const int kDefaultScanThreads = 8;
+
+std::string toLower(std::string value) {
+    std::transform(value.begin(), value.end(), value.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return value;
+}
+
+bool globMatchAt(const char* pattern, const char* text) {
+    while (*pattern) {
+        if (pattern[0] == '*' && pattern[1] == '*') {
+            // '**' cruza carpetas; "**/" también admite cero carpetas
+            pattern += 2;
+            if (*pattern == '/') {
+                if (globMatchAt(pattern + 1, text)) {
+                    return true;
+                }
+            }
+            for (const char* t = text; ; ++t) {
+                if (globMatchAt(pattern, t)) {
+                    return true;
+                }
+                if (!*t) {
+                    return false;
+                }
+            }
+        }
+        
+        if (*pattern == '*') {
+            pattern++;
+            for (const char* t = text; ; ++t) {
+                if (globMatchAt(pattern, t)) {
+                    return true;
+                }
+                if (!*t || *t == '/') {
+                    return false;
+                }
+            }
+        }
+        
+        if (!*text) {
+            return false;
+        }
+        if (*pattern == '?' ? *text == '/' : *pattern != *text) {
+            return false;
+        }
+        pattern++;
+        text++;
+    }
+    return !*text;
+}
+
+} // namespace
+
+DirectoryScanner::DirectoryScanner(const ScanOptions& options)
+    : m_options(options)
+    , m_active(0)
+{
+    for (auto& extension : m_options.extensions) {
+        extension = toLower(extension);
+        if (!extension.empty() && extension[0] != '.') {
+            extension = "." + extension;
+        }
+    }
+    for (auto& pattern : m_options.include) {
+        pattern = toLower(pattern);
+    }
+    for (auto& pattern : m_options.exclude) {
+        pattern = toLower(pattern);
+    }
+}
+
+bool DirectoryScanner::globMatch(const std::string& pattern, const std::string& text) {
+    return globMatchAt(pattern.c_str(), text.c_str());
+}
+
+ScanStats DirectoryScanner::scan(const std::string& root, const FileCallback& onFile) {
+    auto start = std::chrono::steady_clock::now();
+    
+    m_root = fs::path(root);
+    m_onFile = onFile;
+    m_stats = ScanStats();
+    m_directories.clear();
+    m_directories.push_back(m_root);
+    m_active = 0;
+    
+    int threads = m_options.threads > 0 ? m_options.threads : kDefaultScanThreads;
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; ++i) {
+        workers.emplace_back(&DirectoryScanner::workerLoop, this);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    
+    m_stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (!m_options.reportStats) {
+        return m_stats;
+    }
+    std::cout << "Escaneo de " << root << ": " << m_stats.matched << " archivos de " << m_stats.entries
+              << " entradas en " << m_stats.directories << " carpetas (" << m_stats.seconds << " s, "
+              << m_stats.errors << " errores)" << std::endl;
+    return m_stats;
+}
+
+void DirectoryScanner::workerLoop() {
+    while (true) {
+        fs::path directory;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            
+            // Terminado cuando no quedan carpetas ni nadie puede añadir más
+            m_condition.wait(lock, [this]() { return !m_directories.empty() || m_active == 0; });
+            if (m_directories.empty()) {
+                m_condition.notify_all();
+                return;
+            }
+            
+            directory = std::move(m_directories.front());
+            m_directories.pop_front();
+            m_active++;
+        }
+        
+        scanDirectory(directory);
+        
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_active--;
+        }
+        m_condition.notify_all();
+    }
+}
+
+void DirectoryScanner::scanDirectory(const fs::path& directory) {
+    std::vector<fs::path> subdirectories;
+    size_t entries = 0;
+    size_t matched = 0;
+    size_t errors = 0;
+    
+    std::error_code ec;
+    fs::directory_iterator it(directory, fs::directory_options::skip_permission_denied, ec);
+    if (ec) {
+        std::cerr << "No se pudo abrir la carpeta: " << directory.string() << " (" << ec.message() << ")" << std::endl;
+        errors++;
+    }
+    
+    for (fs::directory_iterator end; !ec && it != end; it.increment(ec)) {
+        const fs::directory_entry& entry = *it;
+        entries++;
+        
+        // El tipo suele venir ya del listado, sin un stat por archivo. Los enlaces a carpetas
+        // no se siguen (como recursive_directory_iterator): uno a un antecesor no acabaría nunca
+        std::error_code typeError;
+        bool isDirectory = entry.is_directory(typeError) && !entry.is_symlink(typeError);
+        bool isFile = !isDirectory && entry.is_regular_file(typeError);
+        if (typeError) {
+            errors++;
+            continue;
+        }
+        
+        fs::path relative = entry.path().lexically_relative(m_root);
+        
+        if (isDirectory) {
+            if (m_options.recursive && acceptsDirectory(relative)) {
+                subdirectories.push_back(entry.path());
+            }
+            continue;
+        }
+        
+        if (!isFile || !acceptsFile(relative)) {
+            continue;
+        }
+        
+        matched++;
+        m_onFile(entry.path(), relative);
+    }
+    
+    if (ec) {
+        errors++;
+    }
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.directories++;
+    m_stats.entries += entries;
+    m_stats.matched += matched;
+    m_stats.errors += errors;
+    for (auto& subdirectory : subdirectories) {
+        m_directories.push_back(std::move(subdirectory));
+    }
+}
+
+bool DirectoryScanner::acceptsFile(const fs::path& relative) const {
+    if (!hasExtension(relative)) {
+        return false;
+    }
+    
+    std::string path = toLower(relative.generic_string());
+    std::string name = toLower(relative.filename().string());
+    if (!m_options.include.empty() && !matchesAny(m_options.include, path, name)) {
+        return false;
+    }
+    return !matchesAny(m_options.exclude, path, name);
+}
+
+bool DirectoryScanner::acceptsDirectory(const fs::path& relative) const {
+    return !matchesAny(m_options.exclude, toLower(relative.generic_string()), toLower(relative.filename().string()));
+}
+
+bool DirectoryScanner::matchesAny(const std::vector<std::string>& patterns, const std::string& relative, const std::string& name) const {
+    for (const auto& pattern : patterns) {
+        const std::string& text = pattern.find('/') != std::string::npos ? relative : name;
+        if (globMatch(pattern, text)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool DirectoryScanner::hasExtension(const fs::path& file) const {
+    std::string extension = toLower(file.extension().string());
+    return std::find(m_options.extensions.begin(), m_options.extensions.end(), extension) != m_options.extensions.end();
+}
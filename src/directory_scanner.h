@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <filesystem>
+
+// Qué archivos recoge el escáner
+struct ScanOptions {
+    std::vector<std::string> extensions = { ".stl" };  // Sin distinguir mayúsculas
+    std::vector<std::string> include;   // Globs; vacío = todos los archivos con extensión válida
+    std::vector<std::string> exclude;   // Globs; también podan carpetas enteras
+    bool recursive = true;
+    int threads = 0;                    // 0 = valor por defecto (el recorrido espera sobre todo a E/S)
+    bool reportStats = true;            // Línea de resumen al terminar cada escaneo
+};
+
+struct ScanStats {
+    size_t directories = 0;
+    size_t entries = 0;
+    size_t matched = 0;
+    size_t errors = 0;
+    double seconds = 0.0;
+};
+
+// Recorrido recursivo de carpetas con varios hilos: cada hilo lista una carpeta distinta,
+// así las esperas de disco o de red se solapan. Los globs se comparan con la ruta
+// relativa a la raíz (separador '/') si contienen '/', y si no con el nombre del archivo
+// o carpeta; '*' y '?' no cruzan carpetas y '**' sí. Sin distinguir mayúsculas
+class DirectoryScanner {
+public:
+    using FileCallback = std::function<void(const std::filesystem::path& file, const std::filesystem::path& relative)>;
+    
+    explicit DirectoryScanner(const ScanOptions& options);
+    
+    // Llama a onFile por cada coincidencia según se descubre, desde los hilos del escáner
+    ScanStats scan(const std::string& root, const FileCallback& onFile);
+    
+    // Filtros de extensión, --include y --exclude sobre una ruta relativa a la raíz
+    bool acceptsFile(const std::filesystem::path& relative) const;
+    bool acceptsDirectory(const std::filesystem::path& relative) const;
+    
+    static bool globMatch(const std::string& pattern, const std::string& text);
+
+private:
+    void workerLoop();
+    void scanDirectory(const std::filesystem::path& directory);
+    bool matchesAny(const std::vector<std::string>& patterns, const std::string& relative, const std::string& name) const;
+    bool hasExtension(const std::filesystem::path& file) const;
+    
+    ScanOptions m_options;
+    std::filesystem::path m_root;
+    FileCallback m_onFile;
+    
+    // Carpetas pendientes; m_active cuenta las que se están listando
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<std::filesystem::path> m_directories;
+    size_t m_active;
+    ScanStats m_stats;
+};
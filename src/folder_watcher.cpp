@@ -0,0 +1,296 @@
+#include "folder_watcher.h"
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <algorithm>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Con archivos pendientes se revisa a menudo si ya están estables
+const int kPendingCheckMs = 100;
+
+#ifdef __linux__
+// Escritura terminada, archivos movidos dentro (subidas con renombrado) y cambios en curso
+const uint32_t kWatchMask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MODIFY | IN_CREATE;
+#else
+// Sin notificaciones del sistema: cada cuánto se vuelve a listar
+const auto kRescanInterval = std::chrono::seconds(2);
+#endif
+
+} // namespace
+
+FolderWatcher::FolderWatcher(const ScanOptions& options, int debounceMs)
+    : m_options(options)
+    , m_filter(options)
+    , m_debounceMs(std::max(0, debounceMs))
+#ifdef __linux__
+    , m_inotify(inotify_init1(IN_NONBLOCK | IN_CLOEXEC))
+#endif
+{
+    // Los listados de la vigilancia se repiten a menudo: sin línea de resumen
+    m_options.reportStats = false;
+
+#ifdef __linux__
+    if (m_inotify < 0) {
+        std::cerr << "Error: No se pudo iniciar inotify (" << std::strerror(errno) << ")" << std::endl;
+    }
+#else
+    m_lastScan = std::chrono::steady_clock::now();
+#endif
+}
+
+FolderWatcher::~FolderWatcher() {
+#ifdef __linux__
+    if (m_inotify >= 0) {
+        close(m_inotify);
+    }
+#endif
+}
+
+bool FolderWatcher::addRoot(const std::string& root) {
+    std::error_code ec;
+    if (!fs::is_directory(root, ec)) {
+        std::cerr << "Error: No se puede vigilar, no es una carpeta: " << root << std::endl;
+        return false;
+    }
+    
+    m_roots.push_back(root);
+    size_t index = m_roots.size() - 1;
+
+#ifdef __linux__
+    if (m_inotify < 0 || !addWatchTree(index, root)) {
+        return false;
+    }
+    std::cout << "Vigilando " << root << " (" << m_watches.size() << " carpetas en total)" << std::endl;
+#else
+    // Listado de referencia: solo cuenta lo que cambie a partir de ahora
+    DirectoryScanner scanner(m_options);
+    std::mutex mutex;
+    scanner.scan(root, [&](const fs::path& file, const fs::path&) {
+        std::error_code statError;
+        uintmax_t size = fs::file_size(file, statError);
+        long long modified = static_cast<long long>(fs::last_write_time(file, statError).time_since_epoch().count());
+        std::lock_guard<std::mutex> lock(mutex);
+        m_snapshot[file.string()] = std::make_pair(size, modified);
+    });
+    std::cout << "Vigilando " << root << " (listado cada " << kRescanInterval.count() << " s)" << std::endl;
+#endif
+    return true;
+}
+
+std::vector<WatchedFile> FolderWatcher::poll(int timeoutMs) {
+    waitForChanges(m_pending.empty() ? timeoutMs : std::min(timeoutMs, kPendingCheckMs));
+    
+    std::vector<WatchedFile> ready;
+    auto now = std::chrono::steady_clock::now();
+    for (auto it = m_pending.begin(); it != m_pending.end();) {
+        Pending& pending = it->second;
+        if (std::chrono::duration_cast<std::chrono::milliseconds>(now - pending.lastChange).count() < m_debounceMs) {
+            ++it;
+            continue;
+        }
+        
+        // Borrado antes de terminar de subirse
+        std::error_code ec;
+        uintmax_t size = fs::file_size(it->first, ec);
+        if (ec) {
+            it = m_pending.erase(it);
+            continue;
+        }
+        
+        // Sigue creciendo sin avisar (p. ej. escrito por red): otra espera
+        if (size != pending.size) {
+            pending.size = size;
+            pending.lastChange = now;
+            ++it;
+            continue;
+        }
+        
+        WatchedFile file;
+        file.file = it->first;
+        file.root = pending.root;
+        file.relative = file.file.lexically_relative(m_roots[pending.root]);
+        ready.push_back(std::move(file));
+        it = m_pending.erase(it);
+    }
+    return ready;
+}
+
+void FolderWatcher::markPending(size_t root, const fs::path& file) {
+    if (!m_filter.acceptsFile(file.lexically_relative(m_roots[root]))) {
+        return;
+    }
+    
+    std::error_code ec;
+    Pending& pending = m_pending[file.string()];
+    pending.root = root;
+    pending.size = fs::file_size(file, ec);
+    pending.lastChange = std::chrono::steady_clock::now();
+}
+
+void FolderWatcher::markTree(size_t root, const fs::path& directory) {
+    // Los filtros se aplican respecto a la raíz vigilada, no a la subcarpeta
+    ScanOptions options = m_options;
+    options.include.clear();
+    options.exclude.clear();
+    
+    std::vector<fs::path> files;
+    std::mutex mutex;
+    DirectoryScanner scanner(options);
+    scanner.scan(directory.string(), [&](const fs::path& file, const fs::path&) {
+        std::lock_guard<std::mutex> lock(mutex);
+        files.push_back(file);
+    });
+    
+    for (const auto& file : files) {
+        markPending(root, file);
+    }
+}
+
+#ifdef __linux__
+
+void FolderWatcher::waitForChanges(int timeoutMs) {
+    if (m_inotify < 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+        return;
+    }
+    
+    pollfd descriptor;
+    descriptor.fd = m_inotify;
+    descriptor.events = POLLIN;
+    descriptor.revents = 0;
+    if (::poll(&descriptor, 1, timeoutMs) > 0 && (descriptor.revents & POLLIN)) {
+        readEvents();
+    }
+}
+
+bool FolderWatcher::addWatchTree(size_t root, const fs::path& directory) {
+    int watch = inotify_add_watch(m_inotify, directory.c_str(), kWatchMask);
+    if (watch < 0) {
+        std::cerr << "Error: No se pudo vigilar " << directory.string() << " (" << std::strerror(errno) << ")";
+        if (errno == ENOSPC) {
+            std::cerr << ", subir fs.inotify.max_user_watches";
+        }
+        std::cerr << std::endl;
+        return false;
+    }
+    m_watches[watch] = std::make_pair(root, directory);
+    
+    if (!m_options.recursive) {
+        return true;
+    }
+    
+    std::error_code ec;
+    for (fs::directory_iterator it(directory, fs::directory_options::skip_permission_denied, ec), end; !ec && it != end; it.increment(ec)) {
+        // Sin seguir enlaces, como el escáner: uno a un antecesor no acabaría nunca
+        std::error_code typeError;
+        if (it->is_directory(typeError) && !it->is_symlink(typeError) &&
+            m_filter.acceptsDirectory(it->path().lexically_relative(m_roots[root]))) {
+            addWatchTree(root, it->path());
+        }
+    }
+    return true;
+}
+
+void FolderWatcher::readEvents() {
+    alignas(inotify_event) char buffer[64 * 1024];
+    
+    while (true) {
+        ssize_t length = read(m_inotify, buffer, sizeof(buffer));
+        if (length <= 0) {
+            return;
+        }
+        
+        for (char* cursor = buffer; cursor < buffer + length;) {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(cursor);
+            cursor += sizeof(inotify_event) + event->len;
+            
+            // Cola del núcleo desbordada: se han perdido eventos, revisar todo
+            if (event->mask & IN_Q_OVERFLOW) {
+                std::cerr << "Eventos de inotify perdidos, se revisan las carpetas vigiladas" << std::endl;
+                for (size_t root = 0; root < m_roots.size(); ++root) {
+                    markTree(root, m_roots[root]);
+                }
+                continue;
+            }
+            
+            auto it = m_watches.find(event->wd);
+            if (it == m_watches.end()) {
+                continue;
+            }
+            if (event->mask & IN_IGNORED) {
+                m_watches.erase(it);
+                continue;
+            }
+            if (event->len == 0) {
+                continue;
+            }
+            
+            // Copias: addWatchTree puede reorganizar m_watches
+            size_t root = it->second.first;
+            fs::path path = it->second.second / event->name;
+            
+            if (event->mask & IN_ISDIR) {
+                // Carpeta nueva: vigilarla y recoger lo que ya se escribió dentro
+                if ((event->mask & (IN_CREATE | IN_MOVED_TO)) && m_options.recursive &&
+                    m_filter.acceptsDirectory(path.lexically_relative(m_roots[root]))) {
+                    addWatchTree(root, path);
+                    markTree(root, path);
+                }
+                continue;
+            }
+            
+            markPending(root, path);
+        }
+    }
+}
+
+#else
+
+void FolderWatcher::waitForChanges(int timeoutMs) {
+    auto nextScan = m_lastScan + kRescanInterval;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    std::this_thread::sleep_until(std::min(nextScan, deadline));
+    
+    if (std::chrono::steady_clock::now() >= nextScan) {
+        rescan();
+        m_lastScan = std::chrono::steady_clock::now();
+    }
+}
+
+void FolderWatcher::rescan() {
+    for (size_t root = 0; root < m_roots.size(); ++root) {
+        std::vector<std::pair<fs::path, std::pair<uintmax_t, long long>>> files;
+        std::mutex mutex;
+        
+        DirectoryScanner scanner(m_options);
+        scanner.scan(m_roots[root], [&](const fs::path& file, const fs::path&) {
+            std::error_code ec;
+            uintmax_t size = fs::file_size(file, ec);
+            long long modified = static_cast<long long>(fs::last_write_time(file, ec).time_since_epoch().count());
+            std::lock_guard<std::mutex> lock(mutex);
+            files.emplace_back(file, std::make_pair(size, modified));
+        });
+        
+        // Nuevo o con tamaño/fecha distintos al listado anterior
+        for (const auto& file : files) {
+            auto& known = m_snapshot[file.first.string()];
+            if (known != file.second) {
+                known = file.second;
+                markPending(root, file.first);
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <unordered_map>
+#include "directory_scanner.h"
+
+// Archivo nuevo o modificado que ya dejó de cambiar
+struct WatchedFile {
+    std::filesystem::path file;
+    size_t root = 0;                    // Índice de la carpeta vigilada
+    std::filesystem::path relative;
+};
+
+// Vigila carpetas (y sus subcarpetas) y entrega los STL nuevos o modificados cuando
+// llevan debounceMs sin cambiar, para no leer archivos a medio subir. En Linux usa
+// inotify (las carpetas creadas después también se vigilan); en otros sistemas compara
+// listados periódicos. Los filtros son los mismos que los del escaneo de carpetas.
+// Se usa desde un solo hilo
+class FolderWatcher {
+public:
+    FolderWatcher(const ScanOptions& options, int debounceMs);
+    ~FolderWatcher();
+    
+    bool addRoot(const std::string& root);
+    const std::string& getRoot(size_t index) const { return m_roots[index]; }
+    
+    // Espera cambios hasta timeoutMs y devuelve los archivos ya estables
+    std::vector<WatchedFile> poll(int timeoutMs);
+
+private:
+    struct Pending {
+        size_t root = 0;
+        uintmax_t size = 0;
+        std::chrono::steady_clock::time_point lastChange;
+    };
+    
+    void markPending(size_t root, const std::filesystem::path& file);
+    void markTree(size_t root, const std::filesystem::path& directory);
+    void waitForChanges(int timeoutMs);
+
+#ifdef __linux__
+    bool addWatchTree(size_t root, const std::filesystem::path& directory);
+    void readEvents();
+#else
+    void rescan();
+#endif
+
+    ScanOptions m_options;
+    DirectoryScanner m_filter;
+    int m_debounceMs;
+    std::vector<std::string> m_roots;
+    std::unordered_map<std::string, Pending> m_pending;
+
+#ifdef __linux__
+    int m_inotify;
+    std::unordered_map<int, std::pair<size_t, std::filesystem::path>> m_watches;
+#else
+    // Tamaño y fecha de cada archivo en el último listado
+    std::unordered_map<std::string, std::pair<uintmax_t, long long>> m_snapshot;
+    std::chrono::steady_clock::time_point m_lastScan;
+#endif
+};
@@ -0,0 +1,189 @@
+#include "framebuffer_pool.h"
+#include <glad/glad.h>
+#include <iostream>
+#include <algorithm>
+
+size_t PooledFramebuffer::byteSize() const {
+    // Color RGBA8 + profundidad de 4 bytes por muestra, más el color resuelto con MSAA
+    size_t pixels = (size_t)width * height;
+    size_t bytes = pixels * 8 * std::max(samples, 1);
+    if (samples > 1) bytes += pixels * 4;
+    return bytes;
+}
+
+FramebufferPool::FramebufferPool(size_t maxEntries)
+    : m_capacity(std::max<size_t>(maxEntries, 1))
+    , m_useCounter(0)
+{
+}
+
+FramebufferPool::~FramebufferPool() {
+    // Los recursos GL deben liberarse con clear() mientras el contexto sigue activo
+    if (!m_entries.empty()) {
+        std::cerr << "Advertencia: FramebufferPool destruido con " << m_entries.size() << " framebuffers sin liberar" << std::endl;
+    }
+}
+
+bool FramebufferPool::acquire(int width, int height, int samples, PooledFramebuffer& out) {
+    if (width <= 0 || height <= 0) {
+        std::cerr << "Error: Tamaño de framebuffer inválido: " << width << "x" << height << std::endl;
+        return false;
+    }
+    
+    // Limitar las muestras a lo que soporta el driver
+    samples = std::max(samples, 1);
+    if (samples > 1) {
+        int maxSamples = 0;
+        glGetIntegerv(GL_MAX_SAMPLES, &maxSamples);
+        if (maxSamples > 0) samples = std::min(samples, maxSamples);
+    }
+    
+    for (auto& entry : m_entries) {
+        if (entry.width == width && entry.height == height && entry.samples == samples) {
+            entry.lastUse = ++m_useCounter;
+            out = entry;
+            return true;
+        }
+    }
+    
+    // Hacer sitio antes de reservar memoria de vídeo para el nuevo tamaño
+    evictTo(m_capacity - 1);
+    
+    PooledFramebuffer framebuffer;
+    if (!create(width, height, samples, framebuffer)) {
+        return false;
+    }
+    
+    framebuffer.lastUse = ++m_useCounter;
+    m_entries.push_back(framebuffer);
+    out = framebuffer;
+    
+    std::cout << "Framebuffer " << width << "x" << height << " (" << samples << " muestras) añadido al pool ("
+              << m_entries.size() << "/" << m_capacity << ")" << std::endl;
+    return true;
+}
+
+void FramebufferPool::resolve(const PooledFramebuffer& framebuffer) const {
+    if (framebuffer.samples <= 1) {
+        return;
+    }
+    
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer.fbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer.resolveFbo);
+    glBlitFramebuffer(0, 0, framebuffer.width, framebuffer.height,
+                      0, 0, framebuffer.width, framebuffer.height,
+                      GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void FramebufferPool::setCapacity(size_t maxEntries) {
+    m_capacity = std::max<size_t>(maxEntries, 1);
+    evictTo(m_capacity);
+}
+
+void FramebufferPool::clear() {
+    for (auto& entry : m_entries) {
+        destroy(entry);
+    }
+    m_entries.clear();
+}
+
+size_t FramebufferPool::getMemoryUsage() const {
+    size_t total = 0;
+    for (const auto& entry : m_entries) {
+        total += entry.byteSize();
+    }
+    return total;
+}
+
+void FramebufferPool::evictTo(size_t maxEntries) {
+    while (m_entries.size() > maxEntries) {
+        auto oldest = std::min_element(m_entries.begin(), m_entries.end(),
+            [](const PooledFramebuffer& a, const PooledFramebuffer& b) { return a.lastUse < b.lastUse; });
+        
+        std::cout << "Expulsando framebuffer " << oldest->width << "x" << oldest->height << " del pool" << std::endl;
+        destroy(*oldest);
+        m_entries.erase(oldest);
+    }
+}
+
+bool FramebufferPool::create(int width, int height, int samples, PooledFramebuffer& framebuffer) const {
+    framebuffer.width = width;
+    framebuffer.height = height;
+    framebuffer.samples = samples;
+    
+    // Color y profundidad como renderbuffers: la salida solo se lee con glReadPixels
+    glGenFramebuffers(1, &framebuffer.fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer.fbo);
+    
+    glGenRenderbuffers(1, &framebuffer.color);
+    glBindRenderbuffer(GL_RENDERBUFFER, framebuffer.color);
+    if (samples > 1) {
+        glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_RGBA8, width, height);
+    } else {
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    }
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, framebuffer.color);
+    
+    glGenRenderbuffers(1, &framebuffer.depth);
+    glBindRenderbuffer(GL_RENDERBUFFER, framebuffer.depth);
+    if (samples > 1) {
+        glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_DEPTH_COMPONENT24, width, height);
+    } else {
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    }
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, framebuffer.depth);
+    
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    
+    // Destino de una sola muestra para resolver el MSAA
+    if (complete && samples > 1) {
+        glGenFramebuffers(1, &framebuffer.resolveFbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer.resolveFbo);
+        
+        glGenRenderbuffers(1, &framebuffer.resolveColor);
+        glBindRenderbuffer(GL_RENDERBUFFER, framebuffer.resolveColor);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, framebuffer.resolveColor);
+        
+        complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    }
+    
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    
+    if (!complete) {
+        std::cerr << "Error: Framebuffer incompleto (" << width << "x" << height << ", " << samples << " muestras)" << std::endl;
+        destroy(framebuffer);
+        return false;
+    }
+    
+    return true;
+}
+
+void FramebufferPool::destroy(PooledFramebuffer& framebuffer) const {
+    if (framebuffer.fbo != 0) {
+        glDeleteFramebuffers(1, &framebuffer.fbo);
+        framebuffer.fbo = 0;
+    }
+    
+    if (framebuffer.color != 0) {
+        glDeleteRenderbuffers(1, &framebuffer.color);
+        framebuffer.color = 0;
+    }
+    
+    if (framebuffer.depth != 0) {
+        glDeleteRenderbuffers(1, &framebuffer.depth);
+        framebuffer.depth = 0;
+    }
+    
+    if (framebuffer.resolveFbo != 0) {
+        glDeleteFramebuffers(1, &framebuffer.resolveFbo);
+        framebuffer.resolveFbo = 0;
+    }
+    
+    if (framebuffer.resolveColor != 0) {
+        glDeleteRenderbuffers(1, &framebuffer.resolveColor);
+        framebuffer.resolveColor = 0;
+    }
+}
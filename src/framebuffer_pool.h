@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Framebuffer offscreen con sus attachments (color RGBA8 y profundidad 24 bits)
+struct PooledFramebuffer {
+    unsigned int fbo = 0;
+    unsigned int color = 0;
+    unsigned int depth = 0;
+    
+    // Con MSAA se dibuja en fbo y se resuelve en resolveFbo antes de leer
+    unsigned int resolveFbo = 0;
+    unsigned int resolveColor = 0;
+    
+    int width = 0;
+    int height = 0;
+    int samples = 1;
+    uint64_t lastUse = 0;
+    
+    // Framebuffer desde el que hay que leer los píxeles
+    unsigned int readFbo() const { return samples > 1 ? resolveFbo : fbo; }
+    size_t byteSize() const;
+};
+
+// Pool de framebuffers indexado por (ancho, alto, muestras) con expulsión LRU.
+// Permite que cada trabajo pida su propia resolución sin recrear el contexto
+// ni reasignar attachments cuando se repiten tamaños (miniaturas y renders grandes
+// mezclados en la misma cola). Requiere el contexto OpenGL activo.
+class FramebufferPool {
+public:
+    explicit FramebufferPool(size_t maxEntries = 4);
+    ~FramebufferPool();
+    
+    // Devuelve un framebuffer completo para el tamaño pedido, creándolo si hace falta.
+    // La copia devuelta es válida hasta que la entrada se expulse con otra petición.
+    bool acquire(int width, int height, int samples, PooledFramebuffer& out);
+    
+    // Copia el color multimuestreado al framebuffer de lectura (no hace nada sin MSAA)
+    void resolve(const PooledFramebuffer& framebuffer) const;
+    
+    // Número máximo de framebuffers retenidos (mínimo 1)
+    void setCapacity(size_t maxEntries);
+    size_t getCapacity() const { return m_capacity; }
+    
+    // Libera todos los framebuffers (antes de destruir el contexto)
+    void clear();
+    
+    size_t size() const { return m_entries.size(); }
+    size_t getMemoryUsage() const;
+
+private:
+    bool create(int width, int height, int samples, PooledFramebuffer& framebuffer) const;
+    void destroy(PooledFramebuffer& framebuffer) const;
+    void evictTo(size_t maxEntries);
+    
+    std::vector<PooledFramebuffer> m_entries;
+    size_t m_capacity;
+    uint64_t m_useCounter;
+};
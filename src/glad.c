@@ -156,6 +156,8 @@ int gladLoadGLLoader(GLADloadproc load) {
     glad_glDeleteVertexArrays = (PFNGLDELETEVERTEXARRAYSPROC)fp("glDeleteVertexArrays");
     glad_glDeleteBuffers = (PFNGLDELETEBUFFERSPROC)fp("glDeleteBuffers");
     glad_glBlitFramebuffer = (PFNGLBLITFRAMEBUFFERPROC)fp("glBlitFramebuffer");
+    glad_glRenderbufferStorageMultisample = (PFNGLRENDERBUFFERSTORAGEMULTISAMPLEPROC)fp("glRenderbufferStorageMultisample");
+    glad_glBufferSubData = (PFNGLBUFFERSUBDATAPROC)fp("glBufferSubData");
     
     // Check if all required functions were loaded
     if (glad_glClear == NULL ||
@@ -279,4 +281,6 @@ PFNGLDELETEFRAMEBUFFERSPROC glad_glDeleteFramebuffers = NULL;
 PFNGLDELETERENDERBUFFERSPROC glad_glDeleteRenderbuffers = NULL;
 PFNGLDELETEVERTEXARRAYSPROC glad_glDeleteVertexArrays = NULL;
 PFNGLDELETEBUFFERSPROC glad_glDeleteBuffers = NULL;
-PFNGLBLITFRAMEBUFFERPROC glad_glBlitFramebuffer = NULL; 
\ No newline at end of file
+PFNGLBLITFRAMEBUFFERPROC glad_glBlitFramebuffer = NULL; 
+PFNGLRENDERBUFFERSTORAGEMULTISAMPLEPROC glad_glRenderbufferStorageMultisample = NULL;
+PFNGLBUFFERSUBDATAPROC glad_glBufferSubData = NULL; 
\ No newline at end of file
@@ -0,0 +1,58 @@
+#include "glfw_context.h"
+#include <GLFW/glfw3.h>
+#include <iostream>
+
+GlfwContext::GlfwContext(GLFWwindow* window)
+    : HeadlessContext(HeadlessProvider::Glfw)
+    , m_window(window)
+{
+}
+
+GlfwContext::~GlfwContext() {
+    if (m_window) {
+        glfwDestroyWindow(m_window);
+        glfwTerminate();
+    }
+}
+
+std::unique_ptr<HeadlessContext> GlfwContext::create(int width, int height, bool visible) {
+    if (!glfwInit()) {
+        std::cerr << "Error al inicializar GLFW" << std::endl;
+        return nullptr;
+    }
+    
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, visible ? GLFW_TRUE : GLFW_FALSE);
+    
+    // La ventana oculta solo aporta el contexto; la salida va a framebuffers offscreen
+    GLFWwindow* window = glfwCreateWindow(width, height, visible ? "STL Renderer" : "STL Renderer Headless", NULL, NULL);
+    if (!window) {
+        std::cerr << "Error al crear ventana GLFW" << std::endl;
+        glfwTerminate();
+        return nullptr;
+    }
+    
+    glfwMakeContextCurrent(window);
+    
+    // Activar VSync en la ventana visible para evitar parpadeo
+    if (visible) {
+        glfwSwapInterval(1);
+    }
+    
+    return std::unique_ptr<HeadlessContext>(new GlfwContext(window));
+}
+
+bool GlfwContext::makeCurrent() {
+    glfwMakeContextCurrent(m_window);
+    return true;
+}
+
+void GlfwContext::releaseCurrent() {
+    glfwMakeContextCurrent(nullptr);
+}
+
+void* GlfwContext::getProcAddress(const char* name) {
+    return reinterpret_cast<void*>(glfwGetProcAddress(name));
+}
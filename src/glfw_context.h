@@ -0,0 +1,26 @@
+#pragma once
+
+#include "headless_context.h"
+
+struct GLFWwindow;
+
+// Contexto OpenGL de una ventana GLFW: la ventana de la interfaz o, en modo headless, una
+// ventana oculta como último recurso. Forma parte del ejecutable y no de la biblioteca
+// stlrender; main lo registra con HeadlessContext::setWindowFactory
+class GlfwContext : public HeadlessContext {
+public:
+    ~GlfwContext() override;
+    
+    // Inicializa GLFW y crea la ventana con un contexto 3.3 core ya activo; nullptr si falla
+    static std::unique_ptr<HeadlessContext> create(int width, int height, bool visible);
+    
+    bool makeCurrent() override;
+    void releaseCurrent() override;
+    void* getProcAddress(const char* name) override;
+    void* getNativeWindow() const override { return m_window; }
+
+private:
+    explicit GlfwContext(GLFWwindow* window);
+    
+    GLFWwindow* m_window;
+};
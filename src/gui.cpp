@@ -1,3 +1,4 @@
+#ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
 #define NOMINMAX
 #include <windows.h>
@@ -5,7 +6,9 @@
 #include <combaseapi.h>
 #include <ShlObj.h>
 #include <commdlg.h>
+#include <shellapi.h>
 #pragma comment(lib, "Comdlg32.lib")
+#endif
 
 // Después de Windows, incluir el resto
 #include "gui.h"
@@ -38,7 +41,6 @@
 #include <iomanip>
 #include <ctime>
 #include <chrono>
-#include <shellapi.h>
 
 namespace fs = std::filesystem;
 
@@ -64,6 +66,40 @@ struct GUICallbackData {
 
 static GUICallbackData g_CallbackData;
 
+// Callbacks de entrada: se instalan antes que los de ImGui, que los encadena,
+// y solo marcan la ventana como pendiente de redibujar
+static void redrawOnCursorPos(GLFWwindow*, double, double) {
+    if (g_CallbackData.gui) g_CallbackData.gui->requestRedraw();
+}
+
+static void redrawOnMouseButton(GLFWwindow*, int, int, int) {
+    if (g_CallbackData.gui) g_CallbackData.gui->requestRedraw();
+}
+
+static void redrawOnScroll(GLFWwindow*, double, double) {
+    if (g_CallbackData.gui) g_CallbackData.gui->requestRedraw();
+}
+
+static void redrawOnKey(GLFWwindow*, int, int, int, int) {
+    if (g_CallbackData.gui) g_CallbackData.gui->requestRedraw();
+}
+
+static void redrawOnChar(GLFWwindow*, unsigned int) {
+    if (g_CallbackData.gui) g_CallbackData.gui->requestRedraw();
+}
+
+static void redrawOnFlag(GLFWwindow*, int) {
+    if (g_CallbackData.gui) g_CallbackData.gui->requestRedraw();
+}
+
+static void redrawOnResize(GLFWwindow*, int, int) {
+    if (g_CallbackData.gui) g_CallbackData.gui->requestRedraw();
+}
+
+static void redrawOnRefresh(GLFWwindow*) {
+    if (g_CallbackData.gui) g_CallbackData.gui->requestRedraw();
+}
+
 Gui::Gui(App& app)
     : m_app(app)
     , m_renderer(nullptr)
@@ -77,7 +113,6 @@ Gui::Gui(App& app)
     , m_currentFile("")
     , m_saveFile("")
     , m_batchDirectory("")
-    , m_processingBatch(false)
     , m_cameraYaw(0.0f)
     , m_cameraPitch(0.0f)
     , m_cameraDistance(5.0f)
@@ -111,7 +146,6 @@ Gui::Gui(Renderer& renderer, StlLoader& stlLoader)
     , m_currentFile("")
     , m_saveFile("")
     , m_batchDirectory("")
-    , m_processingBatch(false)
     , m_cameraYaw(0.0f)
     , m_cameraPitch(0.0f)
     , m_cameraDistance(5.0f)
@@ -157,6 +191,9 @@ bool Gui::initialize() {
     // Configurar callback de arrastrar y soltar
     glfwSetDropCallback(m_window, dropCallback);
     
+    // Callbacks de redibujado (antes de ImGui para que los encadene)
+    setupCallbacks();
+    
     // Inicializar ImGui
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
@@ -263,64 +300,8 @@ void Gui::render() {
     // Renderizar la interfaz de ImGui
     ImGui::Render();
     
-    // IMPORTANTE: Primero renderizamos la interfaz de ImGui
+    // La vista previa ya está en una textura dentro de la interfaz
     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-    
-    // DESPUÉS de renderizar la interfaz, renderizamos el modelo 3D encima
-    if (m_previewWindowSize.x > 0 && m_previewWindowSize.y > 0) {
-        // Usar las coordenadas guardadas durante renderPreviewWindow
-        float previewX = m_previewWindowPos.x;
-        float previewY = m_previewWindowPos.y;
-        float previewWidth = m_previewWindowSize.x;
-        float previewHeight = m_previewWindowSize.y;
-        
-        // Guardar el viewport original
-        int originalViewport[4];
-        glGetIntegerv(GL_VIEWPORT, originalViewport);
-        
-        // Activar scissor test para limitar el renderizado al área de vista previa
-        glEnable(GL_SCISSOR_TEST);
-        glScissor(static_cast<int>(previewX), 
-                static_cast<int>(ImGui::GetIO().DisplaySize.y - previewY - previewHeight), 
-                static_cast<int>(previewWidth), 
-                static_cast<int>(previewHeight));
-        
-        // SOLUCIÓN A LA DISTORSIÓN: Configurar el viewport para mantener las proporciones correctas
-        // Usaremos todo el espacio disponible pero ajustaremos la matriz de proyección
-        glViewport(static_cast<int>(previewX), 
-                  static_cast<int>(ImGui::GetIO().DisplaySize.y - previewY - previewHeight), 
-                  static_cast<int>(previewWidth), 
-                  static_cast<int>(previewHeight));
-        
-        // Renderizar el modelo 3D encima de la interfaz
-        try {
-            // Limpiar solo el buffer de profundidad sin afectar el color
-            glClear(GL_DEPTH_BUFFER_BIT);
-            
-            // Obtener referencia al renderer
-            Renderer& renderer = m_app.getRenderer();
-            
-            // Establecer la cámara con los mismos valores exactos que se usarán en el render final
-            renderer.setCameraOrbit(m_cameraYaw, m_cameraPitch, m_cameraDistance);
-            
-            // IMPORTANTE: Establecer una matriz de proyección con el aspect ratio correcto
-            // para evitar la distorsión
-            float aspectRatio = previewWidth / previewHeight;
-            renderer.setProjectionMatrix(45.0f, aspectRatio, 0.1f, 100.0f);
-            
-            // Renderizar el modelo
-            renderer.renderModel();
-        }
-        catch (...) {
-            std::cout << "Error al renderizar modelo desde GUI\n";
-        }
-        
-        // Restaurar el viewport original
-        glViewport(originalViewport[0], originalViewport[1], originalViewport[2], originalViewport[3]);
-        
-        // Desactivar scissor test
-        glDisable(GL_SCISSOR_TEST);
-    }
 }
 
 bool Gui::shouldClose() const {
@@ -331,32 +312,11 @@ void Gui::renderMainMenu() {
     if (ImGui::BeginMenuBar()) {
         if (ImGui::BeginMenu("Archivo")) {
             if (ImGui::MenuItem("Abrir STL...", "Ctrl+O")) {
-                // Mostrar diálogo para abrir archivo
-                char filename[MAX_PATH] = {0};
-                OPENFILENAMEA ofn = {0};
-                ofn.lStructSize = sizeof(ofn);
-                ofn.hwndOwner = glfwGetWin32Window(m_window);
-                ofn.lpstrFilter = "STL Files\0*.stl\0All Files\0*.*\0";
-                ofn.lpstrFile = filename;
-                ofn.nMaxFile = MAX_PATH;
-                ofn.Flags = OFN_EXPLORER | OFN_FILEMUSTEXIST | OFN_HIDEREADONLY;
-                ofn.lpstrDefExt = "stl";
-                
-                if (GetOpenFileNameA(&ofn)) {
-                    m_currentFile = filename;
-                    
-                    // Generar nombre de archivo de salida
-                    fs::path outputPath = m_currentFile;
-                    outputPath.replace_extension();
-                    outputPath += "_png.png";
-                    m_saveFile = outputPath.string();
-                    
-                    // Cargar y renderizar
-                    m_app.renderSingleFile(m_currentFile, m_saveFile);
-                }
+                openFileDialog();
             }
             
             if (ImGui::MenuItem("Guardar imagen...", "Ctrl+S")) {
+#ifdef _WIN32
                 // Mostrar diálogo para guardar imagen
                 char filename[MAX_PATH] = {0};
                 OPENFILENAMEA ofn = {0};
@@ -376,6 +336,9 @@ void Gui::renderMainMenu() {
                         m_app.renderSingleFile(m_currentFile, m_saveFile);
                     }
                 }
+#else
+                std::cout << "Diálogo de guardado solo disponible en Windows; la imagen se guarda en " << m_saveFile << std::endl;
+#endif
             }
             
             ImGui::Separator();
@@ -466,6 +429,7 @@ void Gui::renderCameraControls() {
                 
                 // Aplicar al renderer
                 m_app.getRenderer().setCameraOrbit(m_cameraYaw, m_cameraPitch, m_cameraDistance);
+                requestRedraw();
             } catch (...) {
                 std::cout << "Error al aplicar cambios de cámara desde slider\n";
             }
@@ -499,11 +463,12 @@ void Gui::renderColorControls() {
         
         // Color picker for object inside TreeNode
         if (ImGui::TreeNodeEx("Color del objeto", ImGuiTreeNodeFlags_None)) {
-            ImGui::ColorPicker3("##ModelColorPicker", modelColor, ImGuiColorEditFlags_NoAlpha | ImGuiColorEditFlags_PickerHueWheel);
-            
-            // Actualizar color en la configuración cuando cambia
-            Color newColor(modelColor[0], modelColor[1], modelColor[2]);
-            m_app.setModelColor(newColor);
+            // Actualizar color en la configuración solo cuando cambia
+            if (ImGui::ColorPicker3("##ModelColorPicker", modelColor, ImGuiColorEditFlags_NoAlpha | ImGuiColorEditFlags_PickerHueWheel)) {
+                Color newColor(modelColor[0], modelColor[1], modelColor[2]);
+                m_app.setModelColor(newColor);
+                requestRedraw();
+            }
             
             ImGui::TreePop();
         }
@@ -533,11 +498,12 @@ void Gui::renderColorControls() {
         
         // Color picker for background inside TreeNode
         if (ImGui::TreeNodeEx("Color del fondo", ImGuiTreeNodeFlags_None)) {
-            ImGui::ColorPicker3("##BgColorPicker", bgColor, ImGuiColorEditFlags_NoAlpha | ImGuiColorEditFlags_PickerHueWheel);
-            
-            // Actualizar color en la configuración cuando cambia
-            Color newColor(bgColor[0], bgColor[1], bgColor[2]);
-            m_app.setBackgroundColor(newColor);
+            // Actualizar color en la configuración solo cuando cambia
+            if (ImGui::ColorPicker3("##BgColorPicker", bgColor, ImGuiColorEditFlags_NoAlpha | ImGuiColorEditFlags_PickerHueWheel)) {
+                Color newColor(bgColor[0], bgColor[1], bgColor[2]);
+                m_app.setBackgroundColor(newColor);
+                requestRedraw();
+            }
             
             ImGui::TreePop();
         }
@@ -568,6 +534,7 @@ void Gui::renderBatchControls() {
         ImGui::Text("Carpeta: %s", m_batchDirectory.empty() ? "<ninguna>" : m_batchDirectory.c_str());
         
         if (ImGui::Button("Seleccionar carpeta")) {
+#ifdef _WIN32
             // Mostrar diálogo para seleccionar carpeta
             char path[MAX_PATH] = {0};
             BROWSEINFOA bi = {0};
@@ -583,25 +550,89 @@ void Gui::renderBatchControls() {
                 
                 CoTaskMemFree(pidl);
             }
+#else
+            std::cout << "Selector de carpetas solo disponible en Windows; pasa la carpeta por línea de comandos" << std::endl;
+#endif
         }
         
         ImGui::SameLine();
         
-        // Botón para procesar todos los archivos
+        // Botón para procesar todos los archivos (en segundo plano)
         if (ImGui::Button("Procesar carpeta")) {
-            if (!m_batchDirectory.empty()) {
-                m_processingBatch = true;
-                
-                // Iniciar procesamiento
-                m_app.renderDirectory(m_batchDirectory);
-                
-                m_processingBatch = false;
+            if (!m_batchDirectory.empty() && fs::is_directory(m_batchDirectory)) {
+                int queued = 0;
+                for (const auto& entry : fs::directory_iterator(m_batchDirectory)) {
+                    if (entry.is_regular_file() && entry.path().extension() == ".stl") {
+                        fs::path outputPath = entry.path();
+                        outputPath.replace_extension("png");
+                        m_app.enqueueRender(entry.path().string(), outputPath.string());
+                        queued++;
+                    }
+                }
+                std::cout << "Carpeta encolada: " << queued << " archivos STL" << std::endl;
             }
         }
         
-        // Mostrar progreso si está procesando
-        if (m_processingBatch) {
-            ImGui::ProgressBar(0.5f, ImVec2(-1.0f, 0.0f), "Procesando archivos...");
+        renderJobQueueStatus();
+    }
+}
+
+void Gui::renderJobQueueStatus() {
+    RenderJobQueue& queue = m_app.getJobQueue();
+    RenderQueueStatus status = queue.getStatus();
+    std::vector<RenderJobResult> results = queue.getResults();
+    
+    if (status.total == 0 && results.empty()) {
+        return;
+    }
+    
+    ImGui::Separator();
+    
+    // Progreso de la tanda: terminados más la fracción del trabajo actual
+    size_t finished = status.completed + status.failed;
+    if (status.total > 0) {
+        float fraction = (finished + (status.busy ? status.currentProgress : 0.0f)) / (float)status.total;
+        char overlay[64];
+        snprintf(overlay, sizeof(overlay), "%zu / %zu", finished, status.total);
+        ImGui::ProgressBar(fraction, ImVec2(-1.0f, 0.0f), overlay);
+    }
+    
+    if (status.busy) {
+        ImGui::TextWrapped("Procesando: %s", fs::path(status.currentFile).filename().string().c_str());
+        ImGui::ProgressBar(status.currentProgress, ImVec2(-1.0f, 0.0f));
+        
+        if (status.filesPerSecond > 0.0) {
+            int eta = static_cast<int>(status.etaSeconds + 0.5);
+            ImGui::Text("%.2f archivos/s | Restante: %d:%02d", status.filesPerSecond, eta / 60, eta % 60);
+        } else {
+            ImGui::Text("Calculando ritmo...");
+        }
+        
+        if (ImGui::Button("Cancelar lote")) {
+            queue.cancel();
+        }
+    } else {
+        ImGui::Text("Completados: %zu | Errores: %zu", status.completed, status.failed);
+    }
+    
+    // Lista de resultados (los más recientes primero)
+    if (!results.empty()) {
+        if (ImGui::TreeNodeEx("Resultados", ImGuiTreeNodeFlags_DefaultOpen)) {
+            ImGui::BeginChild("JobResults", ImVec2(0, 150), true);
+            for (auto it = results.rbegin(); it != results.rend(); ++it) {
+                std::string name = fs::path(it->inputFile).filename().string();
+                if (it->success) {
+                    ImGui::Text("OK    %s (%.2f s)", name.c_str(), it->seconds);
+                } else {
+                    ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "ERROR %s", name.c_str());
+                }
+            }
+            ImGui::EndChild();
+            
+            if (!status.busy && ImGui::Button("Limpiar resultados")) {
+                queue.clearResults();
+            }
+            ImGui::TreePop();
         }
     }
 }
@@ -658,6 +689,7 @@ void Gui::renderPreviewWindow() {
                 
                 // Aplicar al renderer
                 m_app.getRenderer().setCameraOrbit(m_cameraYaw, m_cameraPitch, m_cameraDistance);
+                requestRedraw();
             }
             catch (...) {
                 std::cout << "Error al actualizar cámara desde mouse\n";
@@ -679,12 +711,33 @@ void Gui::renderPreviewWindow() {
         try {
             m_app.getConfig().cameraDistance = m_cameraDistance;
             m_app.getRenderer().setCameraOrbit(m_cameraYaw, m_cameraPitch, m_cameraDistance);
+            requestRedraw();
         }
         catch (...) {
             std::cout << "Error al actualizar zoom de cámara\n";
         }
     }
     
+    // Vista previa cacheada en textura: solo se vuelve a dibujar si cambian cámara,
+    // colores, modelo o tamaño del panel (hover, texto o scroll no la tocan)
+    ImVec2 imageSize = ImGui::GetContentRegionAvail();
+    if (imageSize.x >= 1.0f && imageSize.y >= 1.0f) {
+        ImVec2 imagePos = ImGui::GetCursorPos();
+        unsigned int previewTexture = 0;
+        try {
+            previewTexture = m_app.getRenderer().renderPreview(static_cast<int>(imageSize.x), static_cast<int>(imageSize.y));
+        }
+        catch (...) {
+            std::cout << "Error al renderizar modelo desde GUI\n";
+        }
+        
+        if (previewTexture != 0) {
+            // OpenGL guarda las filas de abajo a arriba: invertir la coordenada V
+            ImGui::Image((ImTextureID)(intptr_t)previewTexture, imageSize, ImVec2(0, 1), ImVec2(1, 0));
+        }
+        ImGui::SetCursorPos(imagePos);
+    }
+    
     // Mostrar instrucciones de control
     ImGui::SetCursorPos(ImVec2(10, 10));
     ImGui::Text("Controles: Arrastra para rotar | Rueda para zoom");
@@ -696,7 +749,25 @@ void Gui::renderStatusBar() {
     ImGui::Separator();
     
     // Mostrar información en la barra de estado
-    if (!m_currentFile.empty()) {
+    AsyncModelLoader& loader = m_app.getAsyncLoader();
+    if (loader.isBusy()) {
+        // Progreso real de la carga en segundo plano (bytes y triángulos leídos)
+        char overlay[160];
+        if (loader.getState() == AsyncLoadState::Uploading) {
+            snprintf(overlay, sizeof(overlay), "Subiendo a la GPU: %zu triángulos", loader.getTrianglesParsed());
+        } else {
+            snprintf(overlay, sizeof(overlay), "Cargando: %.1f / %.1f MB, %zu triángulos",
+                     loader.getBytesRead() / (1024.0 * 1024.0), loader.getTotalBytes() / (1024.0 * 1024.0),
+                     loader.getTrianglesParsed());
+        }
+        
+        ImGui::ProgressBar(loader.getProgress(), ImVec2(-80, 0), overlay);
+        ImGui::SameLine();
+        if (ImGui::Button("Cancelar")) {
+            m_pendingLoads.clear();
+            m_app.cancelModelLoad();
+        }
+    } else if (!m_currentFile.empty()) {
         ImGui::Text("Modelo: %s | Salida: %s", 
                     fs::path(m_currentFile).filename().string().c_str(),
                     fs::path(m_saveFile).filename().string().c_str());
@@ -706,7 +777,62 @@ void Gui::renderStatusBar() {
 }
 
 void Gui::setupCallbacks() {
-    // Configurar callbacks adicionales si son necesarios
+    // Entrada que ImGui también escucha (los encadena al instalar los suyos)
+    glfwSetCursorPosCallback(m_window, redrawOnCursorPos);
+    glfwSetMouseButtonCallback(m_window, redrawOnMouseButton);
+    glfwSetScrollCallback(m_window, redrawOnScroll);
+    glfwSetKeyCallback(m_window, redrawOnKey);
+    glfwSetCharCallback(m_window, redrawOnChar);
+    glfwSetWindowFocusCallback(m_window, redrawOnFlag);
+    glfwSetCursorEnterCallback(m_window, redrawOnFlag);
+    
+    // Cambios de tamaño y exposiciones de la ventana
+    glfwSetFramebufferSizeCallback(m_window, redrawOnResize);
+    glfwSetWindowRefreshCallback(m_window, redrawOnRefresh);
+}
+
+void Gui::requestRedraw(int frames) {
+    m_redrawFrames = std::max(m_redrawFrames, frames);
+}
+
+void Gui::queueModelLoad(const std::string& inputFile, const std::string& outputFile) {
+    m_pendingLoads.emplace_back(inputFile, outputFile);
+    startNextLoad();
+}
+
+void Gui::startNextLoad() {
+    // Las cargas se encadenan: la siguiente empieza cuando termina la anterior
+    AsyncModelLoader& loader = m_app.getAsyncLoader();
+    while (!loader.isBusy() && !m_pendingLoads.empty()) {
+        auto next = m_pendingLoads.front();
+        m_pendingLoads.pop_front();
+        
+        m_currentFile = next.first;
+        m_saveFile = next.second;
+        if (m_app.loadModelAsync(m_currentFile)) {
+            break;
+        }
+        std::cerr << "✗ Error al cargar el modelo: " << fs::path(m_currentFile).filename().string() << std::endl;
+    }
+    requestRedraw();
+}
+
+void Gui::onModelLoaded(bool success) {
+    std::string inputName = fs::path(m_currentFile).filename().string();
+    
+    if (!success) {
+        std::cerr << "✗ Error al cargar el modelo: " << inputName << std::endl;
+    } else if (!m_saveFile.empty()) {
+        // Guardar la imagen con el modelo ya en la GPU
+        std::cout << "Renderizando a archivo: " << m_saveFile << std::endl;
+        if (m_app.saveImage(m_saveFile)) {
+            std::cout << "✓ Imagen guardada: " << fs::path(m_saveFile).filename().string() << std::endl;
+        } else {
+            std::cerr << "✗ Error al guardar la imagen: " << fs::path(m_saveFile).filename().string() << std::endl;
+        }
+    }
+    
+    startNextLoad();
 }
 
 void Gui::updateFromConfig() {
@@ -790,6 +916,7 @@ void Gui::dropCallback(GLFWwindow* window, int count, const char** paths) {
     }
     
     // Recorrer cada archivo arrastrado
+    std::string lastModel;
     for (int i = 0; i < count; i++) {
         std::string path = paths[i];
         fs::path filePath(path);
@@ -811,45 +938,17 @@ void Gui::dropCallback(GLFWwindow* window, int count, const char** paths) {
         outputPath += "_png.png";
         std::string outputFile = outputPath.string();
         
-        // Actualizar la interfaz con el archivo actual
-        g_CallbackData.gui->m_currentFile = path;
-        g_CallbackData.gui->m_saveFile = outputFile;
-        
         std::cout << "Archivo STL: " << filePath.filename().string() << std::endl;
         std::cout << "Imagen salida: " << outputPath.filename().string() << std::endl;
         
-        // Paso 1: Cargar el modelo actual
-        std::cout << "Cargando modelo..." << std::endl;
-        if (!g_CallbackData.app->loadModel(path)) {
-            std::cout << "ERROR: No se pudo cargar el modelo" << std::endl;
-            std::cerr << "✗ Error al cargar el modelo: " << filePath.filename().string() << std::endl;
-            continue; // Saltar al siguiente archivo
-        }
-        
-        std::cout << "Modelo cargado exitosamente" << std::endl;
-        
-        // Paso 2: Centrar la cámara para este modelo específico
-        std::cout << "Centrando cámara..." << std::endl;
-        g_CallbackData.app->getRenderer().centerCamera();
-        
-        // Paso 3: Aplicar configuración de cámara
-        float yaw = g_CallbackData.app->getConfig().cameraYaw;
-        float pitch = g_CallbackData.app->getConfig().cameraPitch;
-        float distance = g_CallbackData.app->getConfig().cameraDistance;
-        
-        std::cout << "Aplicando configuración de cámara: yaw=" << yaw << ", pitch=" << pitch << ", distance=" << distance << std::endl;
-        g_CallbackData.app->getRenderer().setCameraOrbit(yaw, pitch, distance);
-        
-        // Paso 4: Guardar la imagen
-        std::cout << "Renderizando a archivo: " << outputFile << std::endl;
-        if (!g_CallbackData.app->saveImage(outputFile)) {
-            std::cout << "ERROR: No se pudo guardar la imagen" << std::endl;
-            std::cerr << "✗ Error al guardar la imagen: " << outputPath.filename().string() << std::endl;
-            continue; // Saltar al siguiente archivo
-        }
-        
-        std::cout << "ÉXITO: Imagen guardada en " << outputFile << std::endl;
-        std::cout << "✓ Imagen guardada: " << outputPath.filename().string() << std::endl;
+        // Render a archivo en la cola de segundo plano
+        g_CallbackData.app->enqueueRender(path, outputFile);
+        lastModel = path;
+    }
+    
+    // Mostrar en la vista previa el último archivo arrastrado (sin volver a guardarlo)
+    if (!lastModel.empty()) {
+        g_CallbackData.gui->queueModelLoad(lastModel, "");
     }
     
     std::cout << "========== FIN PROCESAMIENTO ARRASTRE ==========" << std::endl;
@@ -859,6 +958,7 @@ void Gui::dropCallback(GLFWwindow* window, int count, const char** paths) {
 void Gui::openFileDialog() {
     std::cout << "Gui::openFileDialog() - Mostrando diálogo para abrir archivo\n";
     
+#ifdef _WIN32
     // Mostrar diálogo para abrir archivo
     char filename[MAX_PATH] = {0};
     OPENFILENAMEA ofn = {0};
@@ -880,13 +980,12 @@ void Gui::openFileDialog() {
         outputPath += "_png.png";
         m_saveFile = outputPath.string();
         
-        // Cargar y renderizar
-        if (m_app.renderSingleFile(m_currentFile, m_saveFile)) {
-            std::cout << "Modelo renderizado correctamente\n";
-        } else {
-            std::cout << "Error al renderizar modelo\n";
-        }
+        // Cargar en segundo plano y renderizar al terminar
+        queueModelLoad(m_currentFile, m_saveFile);
     } else {
         std::cout << "Diálogo cancelado o error al abrir\n";
     }
+#else
+    std::cout << "Diálogo de apertura solo disponible en Windows; arrastra el STL a la ventana\n";
+#endif
 } 
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <string>
+#include <deque>
+#include <utility>
 #include <imgui.h>
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
@@ -32,6 +34,15 @@ public:
     // Verificar si se debe cerrar la ventana
     bool shouldClose() const;
     
+    // Redibujado bajo demanda: solo se generan frames tras entrada, cambio de tamaño o carga.
+    // Se piden varios frames para que ImGui asiente hover y animaciones cortas
+    void requestRedraw(int frames = 3);
+    bool needsRedraw() const { return m_redrawFrames > 0; }
+    void frameRendered() { if (m_redrawFrames > 0) m_redrawFrames--; }
+    
+    // Fin de una carga en segundo plano; si tenía imagen de salida asociada se guarda ahora
+    void onModelLoaded(bool success);
+    
     // Abrir diálogo de selección de archivo
     void openFileDialog();
     
@@ -62,13 +73,18 @@ private:
     std::string m_currentFile;
     std::string m_saveFile;
     std::string m_batchDirectory;
-    bool m_processingBatch;
     
     // Configuración de cámara
     float m_cameraYaw;
     float m_cameraPitch;
     float m_cameraDistance;
     
+    // Frames pendientes de dibujar (0 = la ventana está en reposo)
+    int m_redrawFrames = 3;
+    
+    // Archivos pendientes de cargar en segundo plano (entrada, imagen de salida)
+    std::deque<std::pair<std::string, std::string>> m_pendingLoads;
+    
     // Control de cámara con ratón
     bool m_isMouseDragging = false;
     float m_lastMouseX = 0.0f;
@@ -88,9 +104,14 @@ private:
     void renderCameraControls();
     void renderColorControls();
     void renderBatchControls();
+    void renderJobQueueStatus();
     void renderPreviewWindow();
     void renderStatusBar();
     
+    // Carga asíncrona
+    void queueModelLoad(const std::string& inputFile, const std::string& outputFile);
+    void startNextLoad();
+    
     // Configuración de callbacks
     void setupCallbacks();
     
@@ -0,0 +1,468 @@
+#include "headless_context.h"
+#include <glad/glad.h>
+#include <iostream>
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <mutex>
+#include <map>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+HeadlessProvider parseHeadlessProvider(const std::string& name) {
+    std::string value = name;
+    std::transform(value.begin(), value.end(), value.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    
+    if (value == "glfw") return HeadlessProvider::Glfw;
+    if (value == "egl" || value == "egl-surfaceless") return HeadlessProvider::EglSurfaceless;
+    if (value == "egl-device") return HeadlessProvider::EglDevice;
+    if (value == "osmesa") return HeadlessProvider::OSMesa;
+    return HeadlessProvider::Auto;
+}
+
+const char* headlessProviderName(HeadlessProvider provider) {
+    switch (provider) {
+        case HeadlessProvider::Glfw: return "glfw";
+        case HeadlessProvider::EglSurfaceless: return "egl";
+        case HeadlessProvider::EglDevice: return "egl-device";
+        case HeadlessProvider::OSMesa: return "osmesa";
+        default: return "auto";
+    }
+}
+
+namespace {
+
+// Carga dinámica de bibliotecas compartidas
+class SharedLibrary {
+public:
+    SharedLibrary() : m_handle(nullptr) {}
+    ~SharedLibrary() { close(); }
+    
+    SharedLibrary(const SharedLibrary&) = delete;
+    SharedLibrary& operator=(const SharedLibrary&) = delete;
+    
+    // Prueba los nombres en orden hasta que uno se cargue
+    bool open(std::initializer_list<const char*> names) {
+        for (const char* name : names) {
+#ifdef _WIN32
+            m_handle = reinterpret_cast<void*>(LoadLibraryA(name));
+#else
+            m_handle = dlopen(name, RTLD_NOW | RTLD_LOCAL);
+#endif
+            if (m_handle) return true;
+        }
+        return false;
+    }
+    
+    void close() {
+        if (!m_handle) return;
+#ifdef _WIN32
+        FreeLibrary(reinterpret_cast<HMODULE>(m_handle));
+#else
+        dlclose(m_handle);
+#endif
+        m_handle = nullptr;
+    }
+    
+    void* symbol(const char* name) const {
+        if (!m_handle) return nullptr;
+#ifdef _WIN32
+        return reinterpret_cast<void*>(GetProcAddress(reinterpret_cast<HMODULE>(m_handle), name));
+#else
+        return dlsym(m_handle, name);
+#endif
+    }
+    
+    template <typename T>
+    bool load(T& function, const char* name) const {
+        function = reinterpret_cast<T>(symbol(name));
+        return function != nullptr;
+    }
+
+private:
+    void* m_handle;
+};
+
+// Subconjunto de EGL que necesitamos (evita depender de las cabeceras EGL)
+typedef void* EGLDisplay;
+typedef void* EGLConfig;
+typedef void* EGLContext;
+typedef void* EGLSurface;
+typedef void* EGLDeviceEXT;
+typedef int32_t EGLint;
+typedef unsigned int EGLBoolean;
+typedef unsigned int EGLenum;
+
+const EGLint EGL_NONE_ = 0x3038;
+const EGLint EGL_SURFACE_TYPE_ = 0x3033;
+const EGLint EGL_PBUFFER_BIT_ = 0x0001;
+const EGLint EGL_RENDERABLE_TYPE_ = 0x3040;
+const EGLint EGL_OPENGL_BIT_ = 0x0008;
+const EGLint EGL_RED_SIZE_ = 0x3024;
+const EGLint EGL_GREEN_SIZE_ = 0x3023;
+const EGLint EGL_BLUE_SIZE_ = 0x3022;
+const EGLint EGL_ALPHA_SIZE_ = 0x3021;
+const EGLint EGL_DEPTH_SIZE_ = 0x3025;
+const EGLint EGL_EXTENSIONS_ = 0x3055;
+const EGLenum EGL_OPENGL_API_ = 0x30A2;
+const EGLint EGL_CONTEXT_MAJOR_VERSION_ = 0x3098;
+const EGLint EGL_CONTEXT_MINOR_VERSION_ = 0x30FB;
+const EGLint EGL_CONTEXT_OPENGL_PROFILE_MASK_ = 0x30FD;
+const EGLint EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_ = 0x0001;
+const EGLenum EGL_PLATFORM_SURFACELESS_MESA_ = 0x31DD;
+const EGLenum EGL_PLATFORM_DEVICE_EXT_ = 0x313F;
+
+typedef void* (*PFN_eglGetProcAddress)(const char*);
+typedef const char* (*PFN_eglQueryString)(EGLDisplay, EGLint);
+typedef EGLDisplay (*PFN_eglGetPlatformDisplayEXT)(EGLenum, void*, const EGLint*);
+typedef EGLBoolean (*PFN_eglQueryDevicesEXT)(EGLint, EGLDeviceEXT*, EGLint*);
+typedef EGLBoolean (*PFN_eglInitialize)(EGLDisplay, EGLint*, EGLint*);
+typedef EGLBoolean (*PFN_eglTerminate)(EGLDisplay);
+typedef EGLBoolean (*PFN_eglChooseConfig)(EGLDisplay, const EGLint*, EGLConfig*, EGLint, EGLint*);
+typedef EGLBoolean (*PFN_eglBindAPI)(EGLenum);
+typedef EGLContext (*PFN_eglCreateContext)(EGLDisplay, EGLConfig, EGLContext, const EGLint*);
+typedef EGLBoolean (*PFN_eglDestroyContext)(EGLDisplay, EGLContext);
+typedef EGLBoolean (*PFN_eglMakeCurrent)(EGLDisplay, EGLSurface, EGLSurface, EGLContext);
+
+bool hasExtension(const char* extensions, const char* name) {
+    if (!extensions) return false;
+    std::string list = std::string(" ") + extensions + " ";
+    return list.find(std::string(" ") + name + " ") != std::string::npos;
+}
+
+// eglGetPlatformDisplayEXT devuelve el mismo display a todo el proceso y eglTerminate no
+// cuenta usos: solo el último contexto que lo usa lo termina (el renderer principal y los
+// hilos del lote comparten display)
+std::mutex g_eglDisplayMutex;
+std::map<EGLDisplay, int> g_eglDisplayUsers;
+
+class EglContext : public HeadlessContext {
+public:
+    explicit EglContext(HeadlessProvider provider)
+        : HeadlessContext(provider), m_display(nullptr), m_context(nullptr) {}
+    
+    ~EglContext() override {
+        if (m_display) {
+            if (m_context) {
+                releaseCurrent();
+                m_eglDestroyContext(m_display, m_context);
+            }
+            
+            std::lock_guard<std::mutex> lock(g_eglDisplayMutex);
+            if (--g_eglDisplayUsers[m_display] == 0) {
+                g_eglDisplayUsers.erase(m_display);
+                m_eglTerminate(m_display);
+            }
+        }
+    }
+    
+    bool initialize() {
+        if (!m_library.open({
+#ifdef _WIN32
+                "libEGL.dll"
+#else
+                "libEGL.so.1", "libEGL.so"
+#endif
+            })) {
+            std::cerr << "EGL: no se encontró libEGL" << std::endl;
+            return false;
+        }
+        
+        if (!m_library.load(m_eglGetProcAddress, "eglGetProcAddress") ||
+            !m_library.load(m_eglQueryString, "eglQueryString") ||
+            !m_library.load(m_eglInitialize, "eglInitialize") ||
+            !m_library.load(m_eglTerminate, "eglTerminate") ||
+            !m_library.load(m_eglChooseConfig, "eglChooseConfig") ||
+            !m_library.load(m_eglBindAPI, "eglBindAPI") ||
+            !m_library.load(m_eglCreateContext, "eglCreateContext") ||
+            !m_library.load(m_eglDestroyContext, "eglDestroyContext") ||
+            !m_library.load(m_eglMakeCurrent, "eglMakeCurrent")) {
+            std::cerr << "EGL: faltan funciones básicas en libEGL" << std::endl;
+            return false;
+        }
+        
+        // Extensiones de cliente (sin display) para elegir la plataforma
+        const char* clientExtensions = m_eglQueryString(nullptr, EGL_EXTENSIONS_);
+        PFN_eglGetPlatformDisplayEXT getPlatformDisplay =
+            reinterpret_cast<PFN_eglGetPlatformDisplayEXT>(m_eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        if (!getPlatformDisplay) {
+            std::cerr << "EGL: eglGetPlatformDisplayEXT no disponible" << std::endl;
+            return false;
+        }
+        
+        if (m_provider == HeadlessProvider::EglSurfaceless) {
+            if (!hasExtension(clientExtensions, "EGL_MESA_platform_surfaceless")) {
+                std::cerr << "EGL: EGL_MESA_platform_surfaceless no soportado" << std::endl;
+                return false;
+            }
+            m_display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA_, nullptr, nullptr);
+        } else {
+            if (!hasExtension(clientExtensions, "EGL_EXT_platform_device")) {
+                std::cerr << "EGL: EGL_EXT_platform_device no soportado" << std::endl;
+                return false;
+            }
+            PFN_eglQueryDevicesEXT queryDevices =
+                reinterpret_cast<PFN_eglQueryDevicesEXT>(m_eglGetProcAddress("eglQueryDevicesEXT"));
+            EGLDeviceEXT devices[8];
+            EGLint numDevices = 0;
+            if (!queryDevices || !queryDevices(8, devices, &numDevices) || numDevices == 0) {
+                std::cerr << "EGL: no hay dispositivos EGL disponibles" << std::endl;
+                return false;
+            }
+            m_display = getPlatformDisplay(EGL_PLATFORM_DEVICE_EXT_, devices[0], nullptr);
+        }
+        
+        if (!m_display) {
+            std::cerr << "EGL: no se pudo obtener el display" << std::endl;
+            return false;
+        }
+        
+        // Inicializar un display ya inicializado no hace nada más que devolver la versión
+        EGLint major = 0, minor = 0;
+        {
+            std::lock_guard<std::mutex> lock(g_eglDisplayMutex);
+            if (!m_eglInitialize(m_display, &major, &minor)) {
+                std::cerr << "EGL: eglInitialize falló" << std::endl;
+                m_display = nullptr;
+                return false;
+            }
+            g_eglDisplayUsers[m_display]++;
+        }
+        
+        // Sin superficie propia: el contexto se activa con EGL_NO_SURFACE
+        const char* displayExtensions = m_eglQueryString(m_display, EGL_EXTENSIONS_);
+        if (!hasExtension(displayExtensions, "EGL_KHR_surfaceless_context")) {
+            std::cerr << "EGL: EGL_KHR_surfaceless_context no soportado" << std::endl;
+            return false;
+        }
+        
+        const EGLint configAttribs[] = {
+            EGL_SURFACE_TYPE_, EGL_PBUFFER_BIT_,
+            EGL_RENDERABLE_TYPE_, EGL_OPENGL_BIT_,
+            EGL_RED_SIZE_, 8, EGL_GREEN_SIZE_, 8, EGL_BLUE_SIZE_, 8, EGL_ALPHA_SIZE_, 8,
+            EGL_DEPTH_SIZE_, 24,
+            EGL_NONE_
+        };
+        EGLConfig config = nullptr;
+        EGLint numConfigs = 0;
+        if (!m_eglChooseConfig(m_display, configAttribs, &config, 1, &numConfigs) || numConfigs == 0) {
+            std::cerr << "EGL: no hay configuración OpenGL compatible" << std::endl;
+            return false;
+        }
+        
+        if (!m_eglBindAPI(EGL_OPENGL_API_)) {
+            std::cerr << "EGL: la API OpenGL de escritorio no está disponible" << std::endl;
+            return false;
+        }
+        
+        const EGLint contextAttribs[] = {
+            EGL_CONTEXT_MAJOR_VERSION_, 3,
+            EGL_CONTEXT_MINOR_VERSION_, 3,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK_, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_,
+            EGL_NONE_
+        };
+        m_context = m_eglCreateContext(m_display, config, nullptr, contextAttribs);
+        if (!m_context) {
+            std::cerr << "EGL: no se pudo crear el contexto OpenGL 3.3" << std::endl;
+            return false;
+        }
+        
+        std::cout << "Contexto EGL " << major << "." << minor << " creado ("
+                  << headlessProviderName(m_provider) << ")" << std::endl;
+        return true;
+    }
+    
+    bool makeCurrent() override {
+        return m_eglMakeCurrent(m_display, nullptr, nullptr, m_context) != 0;
+    }
+    
+    void releaseCurrent() override {
+        m_eglMakeCurrent(m_display, nullptr, nullptr, nullptr);
+    }
+    
+    void* getProcAddress(const char* name) override {
+        // eglGetProcAddress solo garantiza extensiones en EGL < 1.5, así que
+        // probamos primero la exportación directa de libGL/libOpenGL
+        void* function = m_glLibrary.symbol(name);
+        if (!function) function = m_eglGetProcAddress(name);
+        return function;
+    }
+    
+    void openGLLibrary() {
+        m_glLibrary.open({
+#ifdef _WIN32
+            "opengl32.dll"
+#else
+            "libOpenGL.so.0", "libGL.so.1"
+#endif
+        });
+    }
+
+private:
+    SharedLibrary m_library;
+    SharedLibrary m_glLibrary;
+    EGLDisplay m_display;
+    EGLContext m_context;
+    
+    PFN_eglGetProcAddress m_eglGetProcAddress = nullptr;
+    PFN_eglQueryString m_eglQueryString = nullptr;
+    PFN_eglInitialize m_eglInitialize = nullptr;
+    PFN_eglTerminate m_eglTerminate = nullptr;
+    PFN_eglChooseConfig m_eglChooseConfig = nullptr;
+    PFN_eglBindAPI m_eglBindAPI = nullptr;
+    PFN_eglCreateContext m_eglCreateContext = nullptr;
+    PFN_eglDestroyContext m_eglDestroyContext = nullptr;
+    PFN_eglMakeCurrent m_eglMakeCurrent = nullptr;
+};
+
+// Subconjunto de OSMesa
+typedef void* OSMesaContext;
+const int OSMESA_FORMAT_ = 0x22;
+const int OSMESA_RGBA_ = 0x1908;
+const int OSMESA_DEPTH_BITS_ = 0x30;
+const int OSMESA_PROFILE_ = 0x33;
+const int OSMESA_CORE_PROFILE_ = 0x34;
+const int OSMESA_CONTEXT_MAJOR_VERSION_ = 0x36;
+const int OSMESA_CONTEXT_MINOR_VERSION_ = 0x37;
+
+typedef OSMesaContext (*PFN_OSMesaCreateContextAttribs)(const int*, OSMesaContext);
+typedef void (*PFN_OSMesaDestroyContext)(OSMesaContext);
+typedef unsigned char (*PFN_OSMesaMakeCurrent)(OSMesaContext, void*, unsigned int, int, int);
+typedef void* (*PFN_OSMesaGetProcAddress)(const char*);
+
+class OSMesaHeadlessContext : public HeadlessContext {
+public:
+    OSMesaHeadlessContext() : HeadlessContext(HeadlessProvider::OSMesa), m_context(nullptr) {}
+    
+    ~OSMesaHeadlessContext() override {
+        if (m_context) m_OSMesaDestroyContext(m_context);
+    }
+    
+    bool initialize() {
+        if (!m_library.open({
+#ifdef _WIN32
+                "osmesa.dll"
+#else
+                "libOSMesa.so.8", "libOSMesa.so.6", "libOSMesa.so"
+#endif
+            })) {
+            std::cerr << "OSMesa: no se encontró libOSMesa" << std::endl;
+            return false;
+        }
+        
+        if (!m_library.load(m_OSMesaCreateContextAttribs, "OSMesaCreateContextAttribs") ||
+            !m_library.load(m_OSMesaDestroyContext, "OSMesaDestroyContext") ||
+            !m_library.load(m_OSMesaMakeCurrent, "OSMesaMakeCurrent") ||
+            !m_library.load(m_OSMesaGetProcAddress, "OSMesaGetProcAddress")) {
+            std::cerr << "OSMesa: faltan funciones en libOSMesa" << std::endl;
+            return false;
+        }
+        
+        const int attribs[] = {
+            OSMESA_FORMAT_, OSMESA_RGBA_,
+            OSMESA_DEPTH_BITS_, 24,
+            OSMESA_PROFILE_, OSMESA_CORE_PROFILE_,
+            OSMESA_CONTEXT_MAJOR_VERSION_, 3,
+            OSMESA_CONTEXT_MINOR_VERSION_, 3,
+            0
+        };
+        m_context = m_OSMesaCreateContextAttribs(attribs, nullptr);
+        if (!m_context) {
+            std::cerr << "OSMesa: no se pudo crear el contexto OpenGL 3.3" << std::endl;
+            return false;
+        }
+        
+        std::cout << "Contexto OSMesa creado" << std::endl;
+        return true;
+    }
+    
+    bool makeCurrent() override {
+        // OSMesa exige un buffer de color; basta uno de 1x1 porque se renderiza en FBOs
+        return m_OSMesaMakeCurrent(m_context, m_dummyBuffer, GL_UNSIGNED_BYTE, 1, 1) != 0;
+    }
+    
+    void releaseCurrent() override {
+        m_OSMesaMakeCurrent(nullptr, nullptr, GL_UNSIGNED_BYTE, 0, 0);
+    }
+    
+    void* getProcAddress(const char* name) override {
+        return m_OSMesaGetProcAddress(name);
+    }
+
+private:
+    SharedLibrary m_library;
+    OSMesaContext m_context;
+    unsigned char m_dummyBuffer[4] = {0, 0, 0, 0};
+    
+    PFN_OSMesaCreateContextAttribs m_OSMesaCreateContextAttribs = nullptr;
+    PFN_OSMesaDestroyContext m_OSMesaDestroyContext = nullptr;
+    PFN_OSMesaMakeCurrent m_OSMesaMakeCurrent = nullptr;
+    PFN_OSMesaGetProcAddress m_OSMesaGetProcAddress = nullptr;
+};
+
+// GLAD solo acepta un puntero a función libre. Varios renderers pueden crear su
+// contexto a la vez desde hilos distintos: la carga se serializa
+HeadlessContext* g_loadingContext = nullptr;
+std::mutex g_loadMutex;
+
+// Fábrica de ventanas GLFW; la registra el ejecutable con interfaz
+HeadlessContext::WindowFactory g_windowFactory;
+
+void* loadProcTrampoline(const char* name) {
+    return g_loadingContext ? g_loadingContext->getProcAddress(name) : nullptr;
+}
+
+std::unique_ptr<HeadlessContext> createEgl(HeadlessProvider provider) {
+    std::unique_ptr<EglContext> context(new EglContext(provider));
+    if (!context->initialize()) return nullptr;
+    context->openGLLibrary();
+    return context;
+}
+
+std::unique_ptr<HeadlessContext> createOSMesa() {
+    std::unique_ptr<OSMesaHeadlessContext> context(new OSMesaHeadlessContext());
+    if (!context->initialize()) return nullptr;
+    return context;
+}
+
+} // namespace
+
+std::unique_ptr<HeadlessContext> HeadlessContext::create(HeadlessProvider provider) {
+    switch (provider) {
+        case HeadlessProvider::EglSurfaceless:
+        case HeadlessProvider::EglDevice:
+            return createEgl(provider);
+        case HeadlessProvider::OSMesa:
+            return createOSMesa();
+        case HeadlessProvider::Auto: {
+            // De más rápido a más lento; GLFW queda como último recurso en el renderer
+            std::unique_ptr<HeadlessContext> context = createEgl(HeadlessProvider::EglSurfaceless);
+            if (!context) context = createEgl(HeadlessProvider::EglDevice);
+            if (!context) context = createOSMesa();
+            return context;
+        }
+        default:
+            return nullptr;
+    }
+}
+
+void HeadlessContext::setWindowFactory(const WindowFactory& factory) {
+    g_windowFactory = factory;
+}
+
+std::unique_ptr<HeadlessContext> HeadlessContext::createWindow(int width, int height, bool visible) {
+    return g_windowFactory ? g_windowFactory(width, height, visible) : nullptr;
+}
+
+bool HeadlessContext::loadGL() {
+    std::lock_guard<std::mutex> lock(g_loadMutex);
+    g_loadingContext = this;
+    int loaded = gladLoadGLLoader(loadProcTrampoline);
+    g_loadingContext = nullptr;
+    return loaded != 0;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <functional>
+
+// Proveedor del contexto OpenGL en modo headless
+enum class HeadlessProvider {
+    Auto,           // EGL surfaceless, EGL device, OSMesa y por último ventana GLFW oculta
+    Glfw,           // Ventana GLFW oculta (necesita servidor X/Wayland o escritorio)
+    EglSurfaceless, // EGL con EGL_MESA_platform_surfaceless
+    EglDevice,      // EGL con EGL_EXT_platform_device (GPU sin display)
+    OSMesa          // Mesa por software sin ningún sistema de ventanas
+};
+
+// Convierte el valor de config.ini ("auto", "glfw", "egl", "egl-device", "osmesa")
+HeadlessProvider parseHeadlessProvider(const std::string& name);
+const char* headlessProviderName(HeadlessProvider provider);
+
+// Contexto OpenGL sin ventana. Las bibliotecas (libEGL, libOSMesa) se cargan
+// dinámicamente, así que no son dependencias de compilación: si no están
+// instaladas create() devuelve nullptr y el renderer puede recurrir a GLFW.
+// Como no hay framebuffer por defecto, todo el renderizado va por framebuffers offscreen.
+class HeadlessContext {
+public:
+    virtual ~HeadlessContext() = default;
+    
+    // Crea un contexto OpenGL 3.3 core con el proveedor pedido (Glfw no se gestiona aquí)
+    static std::unique_ptr<HeadlessContext> create(HeadlessProvider provider);
+    
+    // Ventanas GLFW (la de la interfaz, o una oculta como último recurso sin EGL/OSMesa).
+    // Las crea quien enlaza GLFW, para que la biblioteca no dependa de ella: sin fábrica
+    // registrada createWindow devuelve nullptr. El contexto queda activo en el hilo actual
+    using WindowFactory = std::function<std::unique_ptr<HeadlessContext>(int width, int height, bool visible)>;
+    static void setWindowFactory(const WindowFactory& factory);
+    static std::unique_ptr<HeadlessContext> createWindow(int width, int height, bool visible);
+    
+    // Activa/desactiva el contexto en el hilo actual
+    virtual bool makeCurrent() = 0;
+    virtual void releaseCurrent() = 0;
+    
+    // Resolución de funciones OpenGL para GLAD
+    virtual void* getProcAddress(const char* name) = 0;
+    
+    // Carga las funciones OpenGL con GLAD usando este contexto (debe estar activo)
+    bool loadGL();
+    
+    HeadlessProvider getProvider() const { return m_provider; }
+    
+    // GLFWwindow* de los contextos de ventana; nullptr en EGL y OSMesa
+    virtual void* getNativeWindow() const { return nullptr; }
+
+protected:
+    explicit HeadlessContext(HeadlessProvider provider) : m_provider(provider) {}
+    
+    HeadlessProvider m_provider;
+};
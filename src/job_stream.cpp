@@ -0,0 +1,400 @@
+#include "job_stream.h"
+#include <sstream>
+#include <vector>
+#include <iomanip>
+#include <cstdlib>
+#include <cstdio>
+#include <cctype>
+#include <cmath>
+#include <filesystem>
+
+namespace {
+
+// Valor de una clave del trabajo: los trabajos son objetos planos, solo con listas de números
+struct JsonValue {
+    enum Type { String, Number, Bool, Null, Array };
+    Type type = Null;
+    std::string text;               // Cadena ya sin escapes, o el número tal como venía
+    double number = 0.0;
+    bool boolean = false;
+    std::vector<double> numbers;
+};
+
+// Lector de una línea JSON; no admite objetos anidados (ningún campo los usa)
+class JsonReader {
+public:
+    explicit JsonReader(const std::string& text) : m_text(text), m_pos(0) {}
+    
+    void skipSpace() {
+        while (m_pos < m_text.size() && std::isspace(static_cast<unsigned char>(m_text[m_pos]))) {
+            m_pos++;
+        }
+    }
+    
+    bool consume(char expected) {
+        skipSpace();
+        if (m_pos < m_text.size() && m_text[m_pos] == expected) {
+            m_pos++;
+            return true;
+        }
+        return false;
+    }
+    
+    bool atEnd() {
+        skipSpace();
+        return m_pos >= m_text.size();
+    }
+    
+    bool readString(std::string& out) {
+        if (!consume('"')) {
+            return false;
+        }
+        out.clear();
+        while (m_pos < m_text.size()) {
+            char c = m_text[m_pos++];
+            if (c == '"') {
+                return true;
+            }
+            if (static_cast<unsigned char>(c) < 0x20) {
+                return false;
+            }
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (m_pos >= m_text.size()) {
+                return false;
+            }
+            char escape = m_text[m_pos++];
+            switch (escape) {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    unsigned code = 0;
+                    if (!readHex4(code)) {
+                        return false;
+                    }
+                    // Pareja de sustitutos UTF-16 (caracteres fuera del plano básico)
+                    if (code >= 0xD800 && code <= 0xDBFF) {
+                        unsigned low = 0;
+                        if (m_pos + 1 >= m_text.size() || m_text[m_pos] != '\\' || m_text[m_pos + 1] != 'u') {
+                            return false;
+                        }
+                        m_pos += 2;
+                        if (!readHex4(low) || low < 0xDC00 || low > 0xDFFF) {
+                            return false;
+                        }
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    appendUtf8(out, code);
+                    break;
+                }
+                default:
+                    return false;
+            }
+        }
+        return false;
+    }
+    
+    bool readValue(JsonValue& value) {
+        skipSpace();
+        if (m_pos >= m_text.size()) {
+            return false;
+        }
+        
+        char c = m_text[m_pos];
+        if (c == '"') {
+            value.type = JsonValue::String;
+            return readString(value.text);
+        }
+        if (c == '[') {
+            m_pos++;
+            value.type = JsonValue::Array;
+            if (consume(']')) {
+                return true;
+            }
+            do {
+                JsonValue item;
+                if (!readNumber(item)) {
+                    return false;
+                }
+                value.numbers.push_back(item.number);
+            } while (consume(','));
+            return consume(']');
+        }
+        if (readLiteral("true")) {
+            value.type = JsonValue::Bool;
+            value.boolean = true;
+            return true;
+        }
+        if (readLiteral("false")) {
+            value.type = JsonValue::Bool;
+            value.boolean = false;
+            return true;
+        }
+        if (readLiteral("null")) {
+            value.type = JsonValue::Null;
+            return true;
+        }
+        return readNumber(value);
+    }
+
+private:
+    bool readNumber(JsonValue& value) {
+        skipSpace();
+        size_t start = m_pos;
+        while (m_pos < m_text.size() && (std::isdigit(static_cast<unsigned char>(m_text[m_pos])) ||
+               m_text[m_pos] == '-' || m_text[m_pos] == '+' || m_text[m_pos] == '.' ||
+               m_text[m_pos] == 'e' || m_text[m_pos] == 'E')) {
+            m_pos++;
+        }
+        if (m_pos == start) {
+            return false;
+        }
+        
+        value.type = JsonValue::Number;
+        value.text = m_text.substr(start, m_pos - start);
+        char* end = nullptr;
+        value.number = std::strtod(value.text.c_str(), &end);
+        return end == value.text.c_str() + value.text.size();
+    }
+    
+    bool readLiteral(const char* literal) {
+        size_t length = std::char_traits<char>::length(literal);
+        if (m_text.compare(m_pos, length, literal) == 0) {
+            m_pos += length;
+            return true;
+        }
+        return false;
+    }
+    
+    bool readHex4(unsigned& code) {
+        if (m_pos + 4 > m_text.size()) {
+            return false;
+        }
+        code = 0;
+        for (int i = 0; i < 4; ++i) {
+            char c = m_text[m_pos++];
+            code <<= 4;
+            if (c >= '0' && c <= '9') {
+                code |= static_cast<unsigned>(c - '0');
+            } else if (c >= 'a' && c <= 'f') {
+                code |= static_cast<unsigned>(c - 'a' + 10);
+            } else if (c >= 'A' && c <= 'F') {
+                code |= static_cast<unsigned>(c - 'A' + 10);
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    static void appendUtf8(std::string& out, unsigned code) {
+        if (code < 0x80) {
+            out += static_cast<char>(code);
+        } else if (code < 0x800) {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+    
+    const std::string& m_text;
+    size_t m_pos;
+};
+
+bool readColor(const JsonValue& value, Color& color) {
+    if (value.type != JsonValue::Array || value.numbers.size() != 3) {
+        return false;
+    }
+    for (double component : value.numbers) {
+        if (component < 0.0 || component > 1.0) {
+            return false;
+        }
+    }
+    color = Color(static_cast<float>(value.numbers[0]), static_cast<float>(value.numbers[1]), static_cast<float>(value.numbers[2]));
+    return true;
+}
+
+// strtod acepta formas que JSON no admite ("+5", "1.", "1e999"): el id numérico se
+// devuelve reescrito y, si no es finito, entre comillas
+std::string formatJsonNumber(const JsonValue& value) {
+    if (!std::isfinite(value.number)) {
+        return JobStream::quote(value.text);
+    }
+    std::ostringstream out;
+    if (value.number == std::floor(value.number) && std::fabs(value.number) < 1e18) {
+        out << static_cast<long long>(value.number);
+    } else {
+        out << std::setprecision(17) << value.number;
+    }
+    return out.str();
+}
+
+bool readPositiveInt(const JsonValue& value, int& result) {
+    if (value.type != JsonValue::Number || value.number < 1.0 || value.number > 65536.0 ||
+        value.number != static_cast<double>(static_cast<int>(value.number))) {
+        return false;
+    }
+    result = static_cast<int>(value.number);
+    return true;
+}
+
+// Aplica una clave del trabajo; false con el motivo si la clave o el valor no valen
+bool applyField(const std::string& key, const JsonValue& value, StreamJob& job, std::string& error) {
+    RenderJobSettings& settings = job.settings;
+    bool ok = true;
+    
+    if (key == "id") {
+        ok = value.type == JsonValue::String || value.type == JsonValue::Number;
+        if (ok) {
+            job.id = value.type == JsonValue::String ? JobStream::quote(value.text) : formatJsonNumber(value);
+        }
+    } else if (key == "input") {
+        ok = value.type == JsonValue::String && !value.text.empty();
+        job.inputFile = value.text;
+    } else if (key == "output") {
+        ok = value.type == JsonValue::String && !value.text.empty();
+        job.outputFile = value.text;
+    } else if (key == "width") {
+        ok = readPositiveInt(value, settings.width);
+    } else if (key == "height") {
+        ok = readPositiveInt(value, settings.height);
+    } else if (key == "samples") {
+        ok = readPositiveInt(value, settings.samples);
+    } else if (key == "yaw" || key == "pitch" || key == "distance") {
+        ok = value.type == JsonValue::Number;
+        float number = static_cast<float>(value.number);
+        if (key == "yaw") {
+            settings.cameraYaw = number;
+        } else if (key == "pitch") {
+            settings.cameraPitch = number;
+        } else {
+            settings.cameraDistance = number;
+        }
+    } else if (key == "transparent") {
+        ok = value.type == JsonValue::Bool;
+        settings.transparentBackground = value.boolean;
+    } else if (key == "color") {
+        ok = readColor(value, settings.modelColor);
+    } else if (key == "background") {
+        ok = readColor(value, settings.backgroundColor);
+    } else {
+        error = "clave desconocida: " + key;
+        return false;
+    }
+    
+    if (!ok) {
+        error = "valor inválido para " + key;
+    }
+    return ok;
+}
+
+void appendTimings(std::ostringstream& out, const BatchTimings& timings) {
+    out << std::fixed << std::setprecision(2)
+        << ",\"timings_ms\":{\"queue\":" << timings.queueMs
+        << ",\"load\":" << timings.loadMs
+        << ",\"render\":" << timings.renderMs
+        << ",\"encode\":" << timings.encodeMs
+        << ",\"total\":" << timings.totalMs << "}";
+}
+
+} // namespace
+
+bool JobStream::parseJob(const std::string& line, const RenderJobSettings& defaults, StreamJob& job, std::string& error) {
+    job = StreamJob();
+    job.settings = defaults;
+    
+    JsonReader reader(line);
+    if (!reader.consume('{')) {
+        error = "se esperaba un objeto JSON";
+        return false;
+    }
+    
+    if (!reader.consume('}')) {
+        do {
+            std::string key;
+            JsonValue value;
+            if (!reader.readString(key) || !reader.consume(':') || !reader.readValue(value)) {
+                error = "JSON mal formado";
+                return false;
+            }
+            if (!applyField(key, value, job, error)) {
+                return false;
+            }
+        } while (reader.consume(','));
+        
+        if (!reader.consume('}')) {
+            error = "JSON mal formado";
+            return false;
+        }
+    }
+    
+    if (!reader.atEnd()) {
+        error = "texto después del objeto JSON";
+        return false;
+    }
+    if (job.inputFile.empty()) {
+        error = "falta input";
+        return false;
+    }
+    if (job.outputFile.empty()) {
+        job.outputFile = std::filesystem::path(job.inputFile).replace_extension("png").string();
+    }
+    return true;
+}
+
+std::string JobStream::formatResult(const std::string& id, const BatchResult& result) {
+    std::ostringstream out;
+    out << "{\"id\":" << id
+        << ",\"status\":\"" << (result.success ? "ok" : "error") << "\""
+        << ",\"input\":" << quote(result.inputFile)
+        << ",\"output\":" << quote(result.outputFile)
+        << ",\"cached\":" << (result.cached ? "true" : "false");
+    if (!result.success) {
+        out << ",\"error\":" << quote(result.error);
+    }
+    appendTimings(out, result.timings);
+    out << "}";
+    return out.str();
+}
+
+std::string JobStream::formatError(const std::string& id, const std::string& error) {
+    return "{\"id\":" + id + ",\"status\":\"error\",\"error\":" + quote(error) + "}";
+}
+
+std::string JobStream::quote(const std::string& text) {
+    std::string out = "\"";
+    for (char c : text) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+                    out += escaped;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out + "\"";
+}
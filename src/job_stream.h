@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+#include "batch_pipeline.h"
+
+// Trabajo leído de una línea JSON (--jsonl)
+struct StreamJob {
+    std::string id;                 // Ya en JSON (número o cadena); vacío si no venía
+    std::string inputFile;
+    std::string outputFile;         // Por defecto el STL con extensión .png
+    RenderJobSettings settings;
+};
+
+// Formato de --jsonl: un objeto JSON por línea en stdin y un resultado por línea en stdout.
+//   {"id": 7, "input": "a.stl", "output": "a.png", "width": 512, "height": 512,
+//    "yaw": 30, "pitch": 20, "distance": 0, "samples": 4, "transparent": true,
+//    "color": [0.8, 0.8, 0.8], "background": [1, 1, 1]}
+// Solo input es obligatorio; lo demás toma el valor de config.ini. Una clave desconocida
+// es un error (una errata no debe renderizar con otros parámetros sin avisar).
+//   {"id": 7, "status": "ok", "input": "a.stl", "output": "a.png", "cached": false,
+//    "timings_ms": {"queue": 0.4, "load": 3.1, "render": 6.0, "encode": 9.2, "total": 18.7}}
+class JobStream {
+public:
+    // false con el motivo en error; job.id queda relleno si se llegó a leer
+    static bool parseJob(const std::string& line, const RenderJobSettings& defaults, StreamJob& job, std::string& error);
+    
+    static std::string formatResult(const std::string& id, const BatchResult& result);
+    static std::string formatError(const std::string& id, const std::string& error);
+    
+    static std::string quote(const std::string& text);
+};
@@ -1,12 +1,12 @@
 #include "app.h"
 #include <iostream>
-#include <filesystem>
 #include <string>
 #include <vector>
+
+#ifdef _WIN32
 #include <Windows.h>
 #include <shellapi.h>
-
-namespace fs = std::filesystem;
+#endif
 
 #ifdef _WIN32
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nCmdShow) {
@@ -49,25 +49,7 @@ int main(int argc, char* argv[]) {
     // Crear instancia de la aplicación
     App app(false);  // Iniciar en modo no silencioso por defecto
     
-    // Verificar si se recibió un archivo como argumento (arrastrar y soltar)
-    if (argc > 1) {
-        std::string filePath = argv[1];
-        fs::path path(filePath);
-        
-        // Verificar si es un archivo STL
-        if (fs::exists(path) && path.extension() == ".stl") {
-            // Generar nombre para el archivo de salida (mismo nombre + _png.png)
-            fs::path outputPath = path;
-            outputPath.replace_extension();
-            outputPath += "_png.png";
-            
-            // Renderizar archivo directamente sin mostrar GUI
-            app.renderSingleFile(filePath, outputPath.string());
-            return 0;
-        }
-    }
-    
-    // Si no hay argumentos o el procesamiento falló, iniciar la aplicación normal
+    // Como en Windows, todo pasa por run: un STL suelto, varios, carpetas y opciones (--jobs, --resume...)
     return app.run(argc, argv);
 #endif
 } 
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include "memory_budget.h"
+#include <chrono>
+#include <algorithm>
+
+MemoryBudget::MemoryBudget(uint64_t limitBytes)
+    : m_limit(limitBytes)
+    , m_reserved(0)
+    , m_closed(false)
+    , m_nextTicket(0)
+    , m_serving(0)
+{
+    m_stats.limitBytes = limitBytes;
+}
+
+bool MemoryBudget::fits(uint64_t bytes) const {
+    return m_limit == 0 || m_reserved == 0 || m_reserved + bytes <= m_limit;
+}
+
+void MemoryBudget::admit(uint64_t bytes) {
+    if (m_limit > 0 && bytes > m_limit) {
+        m_stats.oversized++;
+    }
+    m_reserved += bytes;
+    m_stats.admitted++;
+    m_stats.peakBytes = std::max(m_stats.peakBytes, m_reserved);
+}
+
+bool MemoryBudget::acquire(uint64_t bytes) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_closed) {
+        return false;
+    }
+    
+    // Sin nadie esperando y con sitio, entra sin turno
+    if (m_nextTicket == m_serving && fits(bytes)) {
+        admit(bytes);
+        return true;
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    uint64_t ticket = m_nextTicket++;
+    m_released.wait(lock, [this, ticket, bytes]() {
+        return m_closed || (ticket == m_serving && fits(bytes));
+    });
+    
+    // El siguiente turno puede caber ya
+    m_serving++;
+    m_stats.waited++;
+    m_stats.waitMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (m_closed) {
+        lock.unlock();
+        m_released.notify_all();
+        return false;
+    }
+    admit(bytes);
+    lock.unlock();
+    m_released.notify_all();
+    return true;
+}
+
+void MemoryBudget::release(uint64_t bytes) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_reserved -= std::min(bytes, m_reserved);
+    }
+    m_released.notify_all();
+}
+
+void MemoryBudget::close() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+    }
+    m_released.notify_all();
+}
+
+MemoryBudgetStats MemoryBudget::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <condition_variable>
+
+struct MemoryBudgetStats {
+    uint64_t limitBytes = 0;        // 0 = sin límite
+    uint64_t peakBytes = 0;         // Máximo reservado a la vez
+    size_t admitted = 0;
+    size_t waited = 0;              // Reservas que tuvieron que esperar a que se liberase memoria
+    size_t oversized = 0;           // Mayores que todo el presupuesto: entraron solos
+    double waitMs = 0.0;
+};
+
+// Presupuesto de memoria para lo que un lote tiene en vuelo a la vez. Cada archivo reserva
+// su huella estimada antes de cargarse y la devuelve al liberarse; acquire bloquea mientras
+// no quepa. Las reservas que esperan entran por orden de llegada (una grande no se queda
+// esperando para siempre detrás de pequeñas), y una mayor que todo el presupuesto entra
+// cuando no queda nada reservado. Con límite 0 no bloquea nunca y solo mide el pico
+class MemoryBudget {
+public:
+    explicit MemoryBudget(uint64_t limitBytes);
+    
+    // false si se cerró mientras esperaba (no se reservó nada)
+    bool acquire(uint64_t bytes);
+    void release(uint64_t bytes);
+    
+    // Despierta a los que esperan para que el lote pueda terminar
+    void close();
+    
+    uint64_t getLimit() const { return m_limit; }
+    MemoryBudgetStats getStats() const;
+
+private:
+    bool fits(uint64_t bytes) const;
+    void admit(uint64_t bytes);
+    
+    const uint64_t m_limit;
+    uint64_t m_reserved;
+    bool m_closed;
+    
+    // Turnos de las reservas en espera
+    uint64_t m_nextTicket;
+    uint64_t m_serving;
+    
+    mutable std::mutex m_mutex;
+    std::condition_variable m_released;
+    MemoryBudgetStats m_stats;
+};
@@ -0,0 +1,316 @@
+#include "png_stream_writer.h"
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+
+namespace {
+
+// Tamaño de cada chunk IDAT antes de volcarlo al archivo
+const size_t kIdatChunkSize = 1 << 16;
+
+// Coincidencia más larga permitida por deflate
+const int kMaxMatch = 258;
+
+// Tabla de longitudes de deflate (códigos 257-285)
+const int kLengthBase[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+const int kLengthExtra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+
+struct CrcTable {
+    uint32_t values[256];
+};
+
+CrcTable makeCrcTable() {
+    CrcTable table;
+    for (uint32_t n = 0; n < 256; ++n) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; ++k) {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        table.values[n] = c;
+    }
+    return table;
+}
+
+uint32_t updateCrc(uint32_t crc, const unsigned char* data, size_t length) {
+    // Estática local: se construye una sola vez aunque varios hilos escriban pósters a la vez
+    static const CrcTable table = makeCrcTable();
+    const uint32_t* crcTable = table.values;
+    for (size_t i = 0; i < length; ++i) {
+        crc = crcTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+void putBigEndian(unsigned char* out, uint32_t value) {
+    out[0] = (unsigned char)(value >> 24);
+    out[1] = (unsigned char)(value >> 16);
+    out[2] = (unsigned char)(value >> 8);
+    out[3] = (unsigned char)value;
+}
+
+} // namespace
+
+PngStreamWriter::PngStreamWriter()
+    : m_width(0)
+    , m_height(0)
+    , m_numChannels(0)
+    , m_rowsWritten(0)
+    , m_open(false)
+    , m_bitBuffer(0)
+    , m_bitCount(0)
+    , m_lastByte(-1)
+    , m_adlerA(1)
+    , m_adlerB(0)
+{
+}
+
+PngStreamWriter::~PngStreamWriter() {
+    if (m_open) {
+        std::cerr << "Advertencia: PNG sin cerrar, archivo incompleto: " << m_filename << std::endl;
+    }
+}
+
+bool PngStreamWriter::open(const std::string& filename, int width, int height, int numChannels) {
+    if (width <= 0 || height <= 0 || (numChannels != 3 && numChannels != 4)) {
+        std::cerr << "Error: Parámetros PNG inválidos (" << width << "x" << height << ", " << numChannels << " canales)" << std::endl;
+        return false;
+    }
+    
+    m_file.open(filename, std::ios::binary);
+    if (!m_file) {
+        std::cerr << "Error: No se pudo crear el archivo: " << filename << std::endl;
+        return false;
+    }
+    
+    m_filename = filename;
+    m_width = width;
+    m_height = height;
+    m_numChannels = numChannels;
+    m_rowsWritten = 0;
+    m_bitBuffer = 0;
+    m_bitCount = 0;
+    m_lastByte = -1;
+    m_adlerA = 1;
+    m_adlerB = 0;
+    m_idat.clear();
+    m_idat.reserve(kIdatChunkSize + 1024);
+    
+    size_t stride = (size_t)width * numChannels;
+    m_previousRow.assign(stride, 0);
+    m_filteredRow.resize(stride + 1);
+    
+    // Firma y cabecera
+    static const unsigned char signature[8] = {137, 80, 78, 71, 13, 10, 26, 10};
+    m_file.write(reinterpret_cast<const char*>(signature), 8);
+    
+    unsigned char ihdr[13];
+    putBigEndian(ihdr, (uint32_t)width);
+    putBigEndian(ihdr + 4, (uint32_t)height);
+    ihdr[8] = 8;                                // Bits por canal
+    ihdr[9] = numChannels == 4 ? 6 : 2;         // RGBA o RGB
+    ihdr[10] = 0;                               // Deflate
+    ihdr[11] = 0;                               // Filtrado adaptativo por fila
+    ihdr[12] = 0;                               // Sin entrelazado
+    writeChunk("IHDR", ihdr, sizeof(ihdr));
+    
+    // Cabecera zlib (deflate, ventana de 32 KB, sin diccionario)
+    m_idat.push_back(0x78);
+    m_idat.push_back(0x01);
+    
+    m_open = true;
+    return m_file.good();
+}
+
+bool PngStreamWriter::writeRows(const unsigned char* rows, int rowCount) {
+    if (!m_open) {
+        return false;
+    }
+    
+    if (m_rowsWritten + rowCount > m_height) {
+        std::cerr << "Error: Demasiadas filas para el PNG " << m_filename << std::endl;
+        return false;
+    }
+    
+    size_t stride = (size_t)m_width * m_numChannels;
+    
+    for (int r = 0; r < rowCount; ++r) {
+        const unsigned char* row = rows + r * stride;
+        
+        // Filtro Sub en la primera fila y Up en las demás: en fondos uniformes
+        // ambos dejan la fila a ceros y las repeticiones la comprimen casi entera
+        if (m_rowsWritten == 0) {
+            m_filteredRow[0] = 1;
+            for (size_t i = 0; i < stride; ++i) {
+                unsigned char left = i >= (size_t)m_numChannels ? row[i - m_numChannels] : 0;
+                m_filteredRow[i + 1] = (unsigned char)(row[i] - left);
+            }
+        } else {
+            m_filteredRow[0] = 2;
+            for (size_t i = 0; i < stride; ++i) {
+                m_filteredRow[i + 1] = (unsigned char)(row[i] - m_previousRow[i]);
+            }
+        }
+        std::memcpy(m_previousRow.data(), row, stride);
+        
+        compressRow(m_filteredRow.data(), m_filteredRow.size());
+        m_rowsWritten++;
+        
+        flushIdat(false);
+    }
+    
+    return m_file.good();
+}
+
+bool PngStreamWriter::close() {
+    if (!m_open) {
+        return false;
+    }
+    
+    // Bloque final vacío para cerrar el flujo deflate
+    writeBits(1, 1);        // BFINAL
+    writeBits(1, 2);        // Huffman fijo
+    writeHuffman(0, 7);     // Fin de bloque (256)
+    flushBits();
+    
+    unsigned char adler[4];
+    putBigEndian(adler, (m_adlerB << 16) | m_adlerA);
+    m_idat.insert(m_idat.end(), adler, adler + 4);
+    flushIdat(true);
+    
+    writeChunk("IEND", nullptr, 0);
+    m_file.close();
+    m_open = false;
+    
+    if (m_rowsWritten != m_height) {
+        std::cerr << "Error: PNG incompleto, " << m_rowsWritten << "/" << m_height << " filas: " << m_filename << std::endl;
+        return false;
+    }
+    
+    return !m_file.fail();
+}
+
+void PngStreamWriter::writeChunk(const char* type, const unsigned char* data, size_t length) {
+    unsigned char header[8];
+    putBigEndian(header, (uint32_t)length);
+    std::memcpy(header + 4, type, 4);
+    m_file.write(reinterpret_cast<const char*>(header), 8);
+    
+    uint32_t crc = updateCrc(0xFFFFFFFFu, header + 4, 4);
+    if (length > 0) {
+        m_file.write(reinterpret_cast<const char*>(data), length);
+        crc = updateCrc(crc, data, length);
+    }
+    
+    unsigned char crcBytes[4];
+    putBigEndian(crcBytes, crc ^ 0xFFFFFFFFu);
+    m_file.write(reinterpret_cast<const char*>(crcBytes), 4);
+}
+
+void PngStreamWriter::flushIdat(bool force) {
+    while (m_idat.size() >= kIdatChunkSize || (force && !m_idat.empty())) {
+        size_t length = std::min(m_idat.size(), kIdatChunkSize);
+        writeChunk("IDAT", m_idat.data(), length);
+        m_idat.erase(m_idat.begin(), m_idat.begin() + length);
+    }
+}
+
+void PngStreamWriter::compressRow(const unsigned char* filtered, size_t length) {
+    // Adler-32 sobre los datos sin comprimir (módulo cada 5552 bytes, sin desbordar)
+    for (size_t start = 0; start < length; start += 5552) {
+        size_t end = std::min(length, start + 5552);
+        for (size_t k = start; k < end; ++k) {
+            m_adlerA += filtered[k];
+            m_adlerB += m_adlerA;
+        }
+        m_adlerA %= 65521u;
+        m_adlerB %= 65521u;
+    }
+    
+    // Un bloque de Huffman fijo por fila; la ventana deflate continúa entre bloques,
+    // así que las repeticiones pueden empezar con el último byte de la fila anterior
+    writeBits(0, 1);        // BFINAL
+    writeBits(1, 2);        // Huffman fijo
+    
+    size_t i = 0;
+    while (i < length) {
+        if (m_lastByte >= 0) {
+            size_t run = 0;
+            while (i + run < length && run < (size_t)kMaxMatch && filtered[i + run] == m_lastByte) {
+                run++;
+            }
+            if (run >= 3) {
+                writeMatch((int)run);
+                i += run;
+                continue;
+            }
+        }
+        
+        writeLiteral(filtered[i]);
+        m_lastByte = filtered[i];
+        i++;
+    }
+    
+    writeHuffman(0, 7);     // Fin de bloque (256)
+}
+
+void PngStreamWriter::writeBits(uint32_t value, int count) {
+    m_bitBuffer |= value << m_bitCount;
+    m_bitCount += count;
+    while (m_bitCount >= 8) {
+        m_idat.push_back((unsigned char)(m_bitBuffer & 0xFF));
+        m_bitBuffer >>= 8;
+        m_bitCount -= 8;
+    }
+}
+
+void PngStreamWriter::writeHuffman(uint32_t code, int length) {
+    // Los códigos Huffman se escriben empezando por el bit más significativo
+    uint32_t reversed = 0;
+    for (int i = 0; i < length; ++i) {
+        reversed = (reversed << 1) | ((code >> i) & 1);
+    }
+    writeBits(reversed, length);
+}
+
+void PngStreamWriter::writeLiteral(int value) {
+    if (value < 144) {
+        writeHuffman(0x30 + value, 8);
+    } else {
+        writeHuffman(0x190 + (value - 144), 9);
+    }
+}
+
+void PngStreamWriter::writeMatch(int length) {
+    int index = 28;
+    while (kLengthBase[index] > length) {
+        index--;
+    }
+    
+    // Códigos 257-279 usan 7 bits, 280-287 usan 8
+    int code = 257 + index;
+    if (code < 280) {
+        writeHuffman(code - 256, 7);
+    } else {
+        writeHuffman(0xC0 + (code - 280), 8);
+    }
+    if (kLengthExtra[index] > 0) {
+        writeBits((uint32_t)(length - kLengthBase[index]), kLengthExtra[index]);
+    }
+    
+    // Distancia 1 (código 0, 5 bits, sin bits extra)
+    writeHuffman(0, 5);
+}
+
+void PngStreamWriter::flushBits() {
+    if (m_bitCount > 0) {
+        m_idat.push_back((unsigned char)(m_bitBuffer & 0xFF));
+    }
+    m_bitBuffer = 0;
+    m_bitCount = 0;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+
+// Escritor PNG por filas: recibe la imagen de arriba a abajo en bandas y la
+// comprime a medida que llega, de modo que la imagen completa nunca está en
+// memoria (pósters de 16k² o 32k² renderizados por tiles).
+// Codifica con deflate de Huffman fijo y coincidencias de repetición (RLE),
+// suficiente para fondos uniformes sin depender de zlib.
+class PngStreamWriter {
+public:
+    PngStreamWriter();
+    ~PngStreamWriter();
+    
+    // Abre el archivo y escribe la cabecera; numChannels es 3 (RGB) o 4 (RGBA)
+    bool open(const std::string& filename, int width, int height, int numChannels);
+    
+    // Añade rowCount filas consecutivas (width * numChannels bytes cada una)
+    bool writeRows(const unsigned char* rows, int rowCount);
+    
+    // Cierra el flujo deflate y escribe IEND; falla si faltan filas
+    bool close();
+    
+    int getRowsWritten() const { return m_rowsWritten; }
+
+private:
+    // Chunks PNG
+    void writeChunk(const char* type, const unsigned char* data, size_t length);
+    void flushIdat(bool force);
+    
+    // Flujo deflate
+    void compressRow(const unsigned char* filtered, size_t length);
+    void writeBits(uint32_t value, int count);
+    void writeHuffman(uint32_t code, int length);
+    void writeLiteral(int value);
+    void writeMatch(int length);
+    void flushBits();
+    
+    std::ofstream m_file;
+    std::string m_filename;
+    int m_width;
+    int m_height;
+    int m_numChannels;
+    int m_rowsWritten;
+    bool m_open;
+    
+    // Filas actual y anterior (para el filtro Up) y fila filtrada
+    std::vector<unsigned char> m_previousRow;
+    std::vector<unsigned char> m_filteredRow;
+    
+    // Estado del compresor
+    uint32_t m_bitBuffer;
+    int m_bitCount;
+    int m_lastByte;         // Último byte sin comprimir emitido (-1 al principio)
+    uint32_t m_adlerA;
+    uint32_t m_adlerB;
+    std::vector<unsigned char> m_idat;
+};
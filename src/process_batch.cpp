@@ -0,0 +1,294 @@
+#include "process_batch.h"
+#include "stl_loader.h"
+#include "batch_journal.h"
+#include <iostream>
+#include <fstream>
+#include <thread>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <spawn.h>
+#include <signal.h>
+#include <sys/wait.h>
+extern char** environ;
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Intervalo entre comprobaciones del estado de los hijos
+const auto kPollInterval = std::chrono::milliseconds(50);
+
+long currentProcessId() {
+#ifdef _WIN32
+    return static_cast<long>(GetCurrentProcessId());
+#else
+    return static_cast<long>(getpid());
+#endif
+}
+
+} // namespace
+
+ProcessBatch::ProcessBatch(const std::string& executable, int jobs)
+    : m_executable(executable)
+    , m_jobs(std::max(1, jobs))
+    , m_nextListId(0)
+    , m_scheduleBySize(true)
+    , m_journal(nullptr)
+{
+}
+
+ProcessBatchResult ProcessBatch::run(const FileList& allFiles) {
+    m_result = ProcessBatchResult();
+    m_pending.clear();
+    
+    // Lo terminado antes del corte no se reparte: su PNG es de una ejecución anterior
+    FileList files;
+    for (const auto& file : allFiles) {
+        if (m_journal && m_journal->isCompleted(file.first, file.second)) {
+            m_result.resumed++;
+            m_result.succeeded++;
+        } else {
+            files.push_back(file);
+        }
+    }
+    if (m_result.resumed > 0) {
+        std::cout << m_result.resumed << " archivos ya terminados según el diario, quedan " << files.size() << std::endl;
+    }
+    if (files.empty()) {
+        return m_result;
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    m_batchStart = fs::file_time_type::clock::now();
+    
+    // Reparto por coste, el más largo primero: cada archivo, de mayor a menor número de
+    // triángulos estimado, va al proceso con menos trabajo acumulado. Así ningún proceso
+    // acaba con dos archivos enormes mientras los demás ya han terminado. Sin él, reparto
+    // intercalado: los archivos grandes y pequeños de una carpeta quedan mezclados
+    int shards = std::min(m_jobs, static_cast<int>(files.size()));
+    m_pending.resize(shards);
+    
+    std::vector<std::pair<uint64_t, size_t>> order;
+    order.reserve(files.size());
+    for (size_t i = 0; i < files.size(); ++i) {
+        // Un archivo ilegible cuenta como uno mínimo: fallará enseguida
+        uint64_t cost = m_scheduleBySize ? std::max<uint64_t>(1, StlLoader::estimateTriangles(files[i].first)) : 1;
+        order.emplace_back(cost, i);
+    }
+    std::stable_sort(order.begin(), order.end(), [](const std::pair<uint64_t, size_t>& a, const std::pair<uint64_t, size_t>& b) {
+        return a.first > b.first;
+    });
+    
+    std::vector<uint64_t> load(shards, 0);
+    for (const auto& entry : order) {
+        size_t target = std::min_element(load.begin(), load.end()) - load.begin();
+        load[target] += entry.first;
+        m_pending[target].files.push_back(files[entry.second]);
+    }
+    
+    std::cout << "Lote en " << shards << " procesos: " << files.size() << " archivos" << std::endl;
+    
+    std::vector<Shard> running;
+    while (!m_pending.empty() || !running.empty()) {
+        // Lanzar mientras haya huecos
+        while (!m_pending.empty() && static_cast<int>(running.size()) < m_jobs) {
+            Shard shard = std::move(m_pending.front());
+            m_pending.pop_front();
+            if (launch(shard)) {
+                running.push_back(std::move(shard));
+            } else {
+                m_result.failed += static_cast<int>(shard.files.size());
+            }
+        }
+        
+        std::this_thread::sleep_for(kPollInterval);
+        
+        for (size_t i = 0; i < running.size();) {
+            bool crashed = false;
+            if (poll(running[i], crashed)) {
+                finish(running[i], crashed);
+                running.erase(running.begin() + i);
+            } else {
+                ++i;
+            }
+        }
+    }
+    
+    m_result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return m_result;
+}
+
+void ProcessBatch::finish(Shard& shard, bool crashed) {
+    std::error_code ec;
+    fs::remove(shard.listPath, ec);
+    
+    FileList missing;
+    for (const auto& file : shard.files) {
+        if (isDone(file.second)) {
+            m_result.succeeded++;
+        } else {
+            missing.push_back(file);
+        }
+    }
+    
+    if (!crashed) {
+        m_result.failed += static_cast<int>(missing.size());
+        return;
+    }
+    
+    m_result.crashes++;
+    if (missing.empty()) {
+        return;
+    }
+    if (missing.size() == 1) {
+        std::cerr << "✗ El proceso se cerró de forma anormal con: " << missing[0].first << std::endl;
+        m_result.failed++;
+        return;
+    }
+    
+    // El culpable está entre los pendientes: partir en dos y seguir buscando
+    std::cerr << "Proceso de trabajo terminado de forma anormal, se reintentan " << missing.size()
+              << " archivos en dos procesos" << std::endl;
+    size_t half = missing.size() / 2;
+    Shard first;
+    Shard second;
+    first.files.assign(missing.begin(), missing.begin() + half);
+    second.files.assign(missing.begin() + half, missing.end());
+    m_pending.push_back(std::move(first));
+    m_pending.push_back(std::move(second));
+}
+
+bool ProcessBatch::isDone(const std::string& outputFile) const {
+    std::error_code ec;
+    if (!fs::exists(outputFile, ec)) {
+        return false;
+    }
+    fs::file_time_type written = fs::last_write_time(outputFile, ec);
+    return !ec && written >= m_batchStart;
+}
+
+bool ProcessBatch::launch(Shard& shard) {
+    shard.listPath = (fs::temp_directory_path() /
+                      ("stlrender_" + std::to_string(currentProcessId()) + "_" + std::to_string(m_nextListId++) + ".txt")).string();
+    if (!writeWorkerList(shard.listPath, shard.files)) {
+        std::cerr << "Error: No se pudo escribir la lista de trabajo: " << shard.listPath << std::endl;
+        return false;
+    }
+    
+    std::string jobs = std::to_string(m_jobs);
+    std::vector<std::string> arguments = m_workerArguments;
+    if (m_journal) {
+        arguments.push_back("--journal");
+        arguments.push_back(m_journal->getPath());
+    }
+
+#ifdef _WIN32
+    std::string commandLine = "\"" + m_executable + "\" --silent --jobs " + jobs + " --worker-list \"" + shard.listPath + "\"";
+    for (const auto& argument : arguments) {
+        commandLine += " \"" + argument + "\"";
+    }
+    
+    STARTUPINFOA startup;
+    PROCESS_INFORMATION info;
+    ZeroMemory(&startup, sizeof(startup));
+    ZeroMemory(&info, sizeof(info));
+    startup.cb = sizeof(startup);
+    
+    if (!CreateProcessA(m_executable.c_str(), &commandLine[0], NULL, NULL, FALSE, 0, NULL, NULL, &startup, &info)) {
+        std::cerr << "Error: No se pudo lanzar el proceso de trabajo (" << GetLastError() << ")" << std::endl;
+        return false;
+    }
+    CloseHandle(info.hThread);
+    shard.process = reinterpret_cast<long long>(info.hProcess);
+#else
+    std::vector<std::string> args = { m_executable, "--silent", "--jobs", jobs, "--worker-list", shard.listPath };
+    args.insert(args.end(), arguments.begin(), arguments.end());
+    std::vector<char*> argv;
+    for (auto& arg : args) {
+        argv.push_back(&arg[0]);
+    }
+    argv.push_back(nullptr);
+    
+    pid_t pid = 0;
+    if (posix_spawn(&pid, m_executable.c_str(), nullptr, nullptr, argv.data(), environ) != 0) {
+        std::cerr << "Error: No se pudo lanzar el proceso de trabajo" << std::endl;
+        return false;
+    }
+    shard.process = pid;
+#endif
+
+    m_result.processesLaunched++;
+    return true;
+}
+
+bool ProcessBatch::poll(Shard& shard, bool& crashed) {
+#ifdef _WIN32
+    HANDLE process = reinterpret_cast<HANDLE>(shard.process);
+    if (WaitForSingleObject(process, 0) != WAIT_OBJECT_0) {
+        return false;
+    }
+    
+    DWORD exitCode = 0;
+    GetExitCodeProcess(process, &exitCode);
+    CloseHandle(process);
+    
+    // Los códigos NTSTATUS de error (0xC0000005 acceso inválido, etc.) indican una excepción
+    crashed = (exitCode & 0xC0000000) == 0xC0000000;
+#else
+    int status = 0;
+    if (waitpid(static_cast<pid_t>(shard.process), &status, WNOHANG) == 0) {
+        return false;
+    }
+    crashed = WIFSIGNALED(status);
+#endif
+    return true;
+}
+
+bool ProcessBatch::writeWorkerList(const std::string& path, const FileList& files) {
+    std::ofstream list(path);
+    if (!list.is_open()) {
+        return false;
+    }
+    for (const auto& file : files) {
+        list << file.first << '\t' << file.second << '\n';
+    }
+    return static_cast<bool>(list);
+}
+
+bool ProcessBatch::readWorkerList(const std::string& path, FileList& files) {
+    std::ifstream list(path);
+    if (!list.is_open()) {
+        return false;
+    }
+    
+    std::string line;
+    while (std::getline(list, line)) {
+        size_t tab = line.find('\t');
+        if (tab != std::string::npos) {
+            files.emplace_back(line.substr(0, tab), line.substr(tab + 1));
+        }
+    }
+    return true;
+}
+
+std::string ProcessBatch::currentExecutable(const char* argv0) {
+#ifdef _WIN32
+    char path[MAX_PATH];
+    DWORD length = GetModuleFileNameA(NULL, path, MAX_PATH);
+    if (length > 0 && length < MAX_PATH) {
+        return std::string(path, length);
+    }
+#else
+    std::error_code ec;
+    fs::path self = fs::read_symlink("/proc/self/exe", ec);
+    if (!ec) {
+        return self.string();
+    }
+#endif
+    return argv0 ? argv0 : "";
+}
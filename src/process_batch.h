@@ -0,0 +1,74 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <chrono>
+#include <filesystem>
+
+class BatchJournal;
+
+// Resultado agregado de un lote repartido entre procesos
+struct ProcessBatchResult {
+    int succeeded = 0;
+    int failed = 0;
+    int processesLaunched = 0;
+    int crashes = 0;            // Procesos que terminaron de forma anormal (excepción, señal)
+    int resumed = 0;            // Ya terminados según el diario (incluidos en succeeded)
+    double seconds = 0.0;
+};
+
+// Lote repartido entre N procesos hijos del propio ejecutable (--jobs N). Cada hijo
+// recibe una lista disjunta de archivos (--worker-list) y la procesa con su propio
+// contexto. Un archivo que tumba el driver solo se lleva por delante a su proceso:
+// lo que quedaba pendiente de ese proceso se parte en dos y se reintenta en procesos
+// nuevos hasta aislar el archivo culpable, que se cuenta como fallido.
+// Un archivo cuenta como hecho si su PNG existe y se escribió durante el lote
+class ProcessBatch {
+public:
+    ProcessBatch(const std::string& executable, int jobs);
+    
+    ProcessBatchResult run(const std::vector<std::pair<std::string, std::string>>& files);
+    
+    // Reparto por triángulos estimados, el más largo primero (por defecto); si no, intercalado
+    void setScheduleBySize(bool enabled) { m_scheduleBySize = enabled; }
+    
+    // Opciones añadidas a la línea de comandos de cada hijo (p. ej. --cache DIR)
+    void setWorkerArguments(const std::vector<std::string>& arguments) { m_workerArguments = arguments; }
+    
+    // Diario del lote: run omite lo que ya marca como hecho y los hijos anotan en él
+    // (--journal) lo que terminan, así --resume sirve también con --jobs
+    void setJournal(BatchJournal* journal) { m_journal = journal; }
+    
+    // Lista de trabajos que lee el proceso hijo (una línea "entrada\tsalida" por archivo)
+    static bool writeWorkerList(const std::string& path, const std::vector<std::pair<std::string, std::string>>& files);
+    static bool readWorkerList(const std::string& path, std::vector<std::pair<std::string, std::string>>& files);
+    
+    // Ruta del ejecutable actual (argv0 si el sistema no la da)
+    static std::string currentExecutable(const char* argv0);
+
+private:
+    using FileList = std::vector<std::pair<std::string, std::string>>;
+    
+    struct Shard {
+        FileList files;
+        std::string listPath;
+        long long process = 0;      // HANDLE en Windows, pid en POSIX
+    };
+    
+    bool launch(Shard& shard);
+    bool poll(Shard& shard, bool& crashed);
+    void finish(Shard& shard, bool crashed);
+    bool isDone(const std::string& outputFile) const;
+    
+    std::string m_executable;
+    int m_jobs;
+    int m_nextListId;
+    bool m_scheduleBySize;
+    std::vector<std::string> m_workerArguments;
+    BatchJournal* m_journal;
+    std::filesystem::file_time_type m_batchStart;
+    
+    std::deque<Shard> m_pending;
+    ProcessBatchResult m_result;
+};
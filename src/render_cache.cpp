@@ -0,0 +1,219 @@
+#include "render_cache.h"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <cstring>
+#include <algorithm>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Dos hashes de 64 bits independientes: con millones de piezas una colisión sería una
+// imagen equivocada, así que la clave tiene 128 bits
+const uint64_t kSeedA = 14695981039346656037ULL;
+const uint64_t kSeedB = 0x9E3779B97F4A7C15ULL;
+const uint64_t kPrimeA = 1099511628211ULL;
+const uint64_t kPrimeB = 0xC2B2AE3D27D4EB4FULL;
+
+uint64_t rotate(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// Mezcla por palabras de 8 bytes (la geometría puede ocupar cientos de MB)
+void hashBytes(const unsigned char* data, size_t length, uint64_t& a, uint64_t& b) {
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        a = (a ^ word) * kPrimeA;
+        b = rotate(b ^ (word * kPrimeB), 31) * kSeedB;
+    }
+    for (; i < length; ++i) {
+        a = (a ^ data[i]) * kPrimeA;
+        b = rotate(b ^ (data[i] * kPrimeB), 31) * kSeedB;
+    }
+}
+
+} // namespace
+
+RenderCache::RenderCache(const std::string& directory, uint64_t maxBytes)
+    : m_directory(directory)
+    , m_maxBytes(maxBytes)
+    , m_bytes(0)
+{
+    std::error_code ec;
+    fs::create_directories(m_directory, ec);
+    if (ec) {
+        std::cerr << "Error: No se pudo crear la caché de renders: " << m_directory << " (" << ec.message() << ")" << std::endl;
+    }
+    loadIndex();
+}
+
+std::string RenderCache::makeKey(const Model& model, const std::string& parameters) {
+    uint64_t a = kSeedA ^ model.triangles.size();
+    uint64_t b = kSeedB;
+    hashBytes(reinterpret_cast<const unsigned char*>(model.triangles.data()), model.triangles.size() * sizeof(Triangle), a, b);
+    hashBytes(reinterpret_cast<const unsigned char*>(parameters.data()), parameters.size(), a, b);
+    
+    std::ostringstream key;
+    key << std::hex << std::setfill('0') << std::setw(16) << a << std::setw(16) << b;
+    return key.str();
+}
+
+bool RenderCache::fetch(const std::string& key, const std::string& outputFile) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(key);
+        if (it == m_entries.end()) {
+            m_stats.misses++;
+            return false;
+        }
+        m_lru.splice(m_lru.begin(), m_lru, it->second.position);
+    }
+    
+    // La fecha marca el uso para el LRU de la próxima ejecución, y también cuenta como
+    // "escrito en este lote" para --jobs y el manifiesto (el enlace comparte la fecha)
+    std::string cached = pathFor(key);
+    std::error_code ec;
+    fs::last_write_time(cached, fs::file_time_type::clock::now(), ec);
+    
+    // Se sustituye la salida anterior en lugar de escribir encima
+    fs::remove(outputFile, ec);
+    fs::create_hard_link(cached, outputFile, ec);
+    if (ec) {
+        // Otro volumen o sistema de archivos sin enlaces
+        ec.clear();
+        fs::copy_file(cached, outputFile, fs::copy_options::overwrite_existing, ec);
+    }
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (ec) {
+        // El archivo desapareció de la caché por fuera: olvidar la entrada
+        auto it = m_entries.find(key);
+        if (it != m_entries.end()) {
+            m_bytes -= it->second.size;
+            m_lru.erase(it->second.position);
+            m_entries.erase(it);
+        }
+        m_stats.misses++;
+        return false;
+    }
+    m_stats.hits++;
+    return true;
+}
+
+bool RenderCache::store(const std::string& key, const std::string& outputFile) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_entries.count(key) > 0) {
+            return true;
+        }
+    }
+    
+    std::string cached = pathFor(key);
+    std::error_code ec;
+    fs::create_directories(fs::path(cached).parent_path(), ec);
+    
+    // Copia temporal y renombrado: otro proceso de --jobs nunca ve un PNG a medias
+    std::ostringstream temp;
+    temp << cached << "." << std::this_thread::get_id() << ".tmp";
+    fs::copy_file(outputFile, temp.str(), fs::copy_options::overwrite_existing, ec);
+    if (!ec) {
+        fs::rename(temp.str(), cached, ec);
+    }
+    if (ec) {
+        std::error_code ignored;
+        fs::remove(temp.str(), ignored);
+        std::cerr << "No se pudo guardar en la caché de renders: " << outputFile << " (" << ec.message() << ")" << std::endl;
+        return false;
+    }
+    
+    uint64_t size = fs::file_size(cached, ec);
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    insert(key, ec ? 0 : size);
+    m_stats.stored++;
+    evict();
+    return true;
+}
+
+RenderCacheStats RenderCache::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    RenderCacheStats stats = m_stats;
+    stats.entries = m_entries.size();
+    stats.bytes = m_bytes;
+    return stats;
+}
+
+void RenderCache::loadIndex() {
+    // Más antiguo primero, para que el más reciente quede delante al insertar
+    std::vector<std::pair<fs::file_time_type, std::pair<std::string, uint64_t>>> files;
+    
+    std::error_code ec;
+    for (fs::recursive_directory_iterator it(m_directory, ec), end; !ec && it != end; it.increment(ec)) {
+        std::error_code entryError;
+        if (!it->is_regular_file(entryError) || it->path().extension() != ".png") {
+            continue;
+        }
+        uint64_t size = it->file_size(entryError);
+        fs::file_time_type time = it->last_write_time(entryError);
+        if (!entryError) {
+            files.push_back(std::make_pair(time, std::make_pair(it->path().stem().string(), size)));
+        }
+    }
+    
+    std::sort(files.begin(), files.end(), [](const auto& left, const auto& right) { return left.first < right.first; });
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& file : files) {
+        insert(file.second.first, file.second.second);
+    }
+    evict();
+    
+    std::cout << "Caché de renders: " << m_entries.size() << " imágenes, " << m_bytes / (1024 * 1024) << " MB de "
+              << m_maxBytes / (1024 * 1024) << " MB (" << m_directory << ")" << std::endl;
+}
+
+void RenderCache::insert(const std::string& key, uint64_t size) {
+    // Dos piezas idénticas que fallaron a la vez guardan la misma clave: un solo nodo
+    auto existing = m_entries.find(key);
+    if (existing != m_entries.end()) {
+        m_lru.splice(m_lru.begin(), m_lru, existing->second.position);
+        m_bytes = m_bytes - existing->second.size + size;
+        existing->second.size = size;
+        return;
+    }
+    
+    m_lru.push_front(key);
+    Entry entry;
+    entry.position = m_lru.begin();
+    entry.size = size;
+    m_entries[key] = entry;
+    m_bytes += size;
+}
+
+void RenderCache::evict() {
+    while (m_bytes > m_maxBytes && !m_lru.empty()) {
+        const std::string& key = m_lru.back();
+        auto it = m_entries.find(key);
+        if (it != m_entries.end()) {
+            m_bytes -= it->second.size;
+            m_entries.erase(it);
+        }
+        
+        // Las salidas enlazadas a este archivo siguen intactas
+        std::error_code ec;
+        fs::remove(pathFor(key), ec);
+        m_lru.pop_back();
+        m_stats.evicted++;
+    }
+}
+
+std::string RenderCache::pathFor(const std::string& key) const {
+    // Subcarpetas por los dos primeros caracteres: ninguna carpeta con millones de archivos
+    return (fs::path(m_directory) / key.substr(0, 2) / (key + ".png")).string();
+}
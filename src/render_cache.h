@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include "model.h"
+
+struct RenderCacheStats {
+    size_t entries = 0;
+    uint64_t bytes = 0;
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t stored = 0;
+    size_t evicted = 0;
+};
+
+// Caché local de imágenes direccionada por contenido: la clave es un hash de la
+// geometría ya decodificada más la huella de los parámetros de render, así que piezas
+// idénticas con nombres distintos comparten imagen. Un acierto enlaza (o copia) el PNG
+// guardado en lugar de renderizar. Tamaño acotado con LRU; el orden se conserva entre
+// ejecuciones con la fecha de cada archivo. Seguro desde varios hilos
+class RenderCache {
+public:
+    RenderCache(const std::string& directory, uint64_t maxBytes);
+    
+    static std::string makeKey(const Model& model, const std::string& parameters);
+    
+    // Deja en outputFile la imagen de la clave; false si no está
+    bool fetch(const std::string& key, const std::string& outputFile);
+    
+    // Guarda una copia del PNG recién escrito (no un enlace: la salida es del usuario)
+    bool store(const std::string& key, const std::string& outputFile);
+    
+    RenderCacheStats getStats() const;
+    const std::string& getDirectory() const { return m_directory; }
+
+private:
+    struct Entry {
+        std::list<std::string>::iterator position;
+        uint64_t size = 0;
+    };
+    
+    void loadIndex();
+    void insert(const std::string& key, uint64_t size);
+    void evict();
+    std::string pathFor(const std::string& key) const;
+    
+    std::string m_directory;
+    uint64_t m_maxBytes;
+    
+    // m_lru: más reciente delante
+    mutable std::mutex m_mutex;
+    std::list<std::string> m_lru;
+    std::unordered_map<std::string, Entry> m_entries;
+    uint64_t m_bytes;
+    RenderCacheStats m_stats;
+};
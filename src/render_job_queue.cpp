@@ -0,0 +1,239 @@
+#include "render_job_queue.h"
+#include "stl_loader.h"
+#include <iostream>
+
+namespace {
+
+// Parte del progreso de cada trabajo que corresponde a la lectura del STL
+const float kLoadProgressShare = 0.8f;
+
+} // namespace
+
+RenderJobQueue::RenderJobQueue()
+    : m_stop(false)
+    , m_backend(RenderBackend::OpenGL)
+    , m_provider(HeadlessProvider::Auto)
+    , m_working(false)
+    , m_batchTotal(0)
+    , m_batchCompleted(0)
+    , m_batchFailed(0)
+    , m_currentProgress(0.0f)
+    , m_cancelCurrent(false)
+{
+}
+
+RenderJobQueue::~RenderJobQueue() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+        m_pending.clear();
+    }
+    m_cancelCurrent = true;
+    m_condition.notify_all();
+    
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void RenderJobQueue::setBackend(RenderBackend backend, HeadlessProvider provider) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_backend = backend;
+    
+    // El hilo de trabajo no puede abrir ventanas GLFW: Auto prueba EGL y OSMesa
+    m_provider = provider == HeadlessProvider::Glfw ? HeadlessProvider::Auto : provider;
+}
+
+void RenderJobQueue::enqueue(const RenderJob& job) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        
+        // Una tanda nueva empieza cuando la cola estaba vacía
+        if (m_pending.empty() && !m_working) {
+            m_batchTotal = 0;
+            m_batchCompleted = 0;
+            m_batchFailed = 0;
+            m_batchStart = std::chrono::steady_clock::now();
+        }
+        
+        m_pending.push_back(job);
+        m_batchTotal++;
+        
+        // El hilo se crea con el primer trabajo y vive hasta que se destruye la cola
+        if (!m_thread.joinable()) {
+            m_thread = std::thread(&RenderJobQueue::workerLoop, this);
+        }
+    }
+    m_condition.notify_one();
+}
+
+void RenderJobQueue::cancel() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t discarded = m_pending.size();
+    m_pending.clear();
+    m_batchTotal -= discarded;
+    m_cancelCurrent = m_working;
+    
+    std::cout << "Cola de renders cancelada (" << discarded << " trabajos descartados)" << std::endl;
+}
+
+RenderQueueStatus RenderJobQueue::getStatus() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    RenderQueueStatus status;
+    status.busy = m_working || !m_pending.empty();
+    status.pending = m_pending.size();
+    status.completed = m_batchCompleted;
+    status.failed = m_batchFailed;
+    status.total = m_batchTotal;
+    status.currentFile = m_currentFile;
+    status.currentProgress = m_currentProgress.load();
+    
+    // Ritmo medio de la tanda y tiempo restante estimado con él
+    size_t finished = m_batchCompleted + m_batchFailed;
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_batchStart).count();
+    if (finished > 0 && elapsed > 0.0) {
+        status.filesPerSecond = finished / elapsed;
+        double remaining = (double)status.pending + (m_working ? 1.0 - status.currentProgress : 0.0);
+        status.etaSeconds = remaining / status.filesPerSecond;
+    }
+    
+    return status;
+}
+
+std::vector<RenderJobResult> RenderJobQueue::getResults() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_results;
+}
+
+void RenderJobQueue::clearResults() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_results.clear();
+}
+
+bool RenderJobQueue::isBusy() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_working || !m_pending.empty();
+}
+
+void RenderJobQueue::workerLoop() {
+    // El renderer y su contexto pertenecen a este hilo durante toda su vida
+    Renderer renderer;
+    StlLoader loader;
+    
+    StlLoadProgress progress;
+    progress.onRead = [this](uint64_t bytesRead, uint64_t totalBytes, size_t) {
+        if (totalBytes > 0) {
+            m_currentProgress = kLoadProgressShare * (float)bytesRead / (float)totalBytes;
+        }
+    };
+    progress.isCancelled = [this]() {
+        return m_cancelCurrent.load();
+    };
+    loader.setProgressHandler(progress);
+    
+    while (true) {
+        RenderJob job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_stop || !m_pending.empty(); });
+            if (m_stop) {
+                break;
+            }
+            
+            job = m_pending.front();
+            m_pending.pop_front();
+            m_working = true;
+            m_currentFile = job.inputFile;
+            m_currentProgress = 0.0f;
+            m_cancelCurrent = false;
+        }
+        
+        auto jobStart = std::chrono::steady_clock::now();
+        bool success = runJob(renderer, loader, job);
+        
+        RenderJobResult result;
+        result.inputFile = job.inputFile;
+        result.outputFile = job.outputFile;
+        result.success = success;
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - jobStart).count();
+        
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_results.push_back(result);
+        if (success) {
+            m_batchCompleted++;
+        } else {
+            m_batchFailed++;
+        }
+        m_working = false;
+        m_currentFile.clear();
+        m_currentProgress = 0.0f;
+    }
+}
+
+bool RenderJobQueue::initializeRenderer(Renderer& renderer, const RenderJobSettings& settings) {
+    if (renderer.isInitialized()) {
+        // Contexto caliente: solo ajustar el tamaño y vaciar la escena
+        return renderer.initializeHeadless(settings.width, settings.height);
+    }
+    
+    RenderBackend backend;
+    HeadlessProvider provider;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        backend = m_backend;
+        provider = m_provider;
+    }
+    
+    renderer.setBackend(backend);
+    renderer.setHeadlessProvider(provider);
+    renderer.setWindowFallback(false);
+    if (renderer.initializeHeadless(settings.width, settings.height)) {
+        return true;
+    }
+    
+    if (backend == RenderBackend::Software) {
+        return false;
+    }
+    
+    // Sin EGL ni OSMesa en este sistema: seguir con el rasterizador por CPU
+    std::cout << "Cola de renders: sin contexto OpenGL sin ventana, usando el renderer por software" << std::endl;
+    renderer.setBackend(RenderBackend::Software);
+    return renderer.initializeHeadless(settings.width, settings.height);
+}
+
+bool RenderJobQueue::runJob(Renderer& renderer, StlLoader& loader, const RenderJob& job) {
+    const RenderJobSettings& settings = job.settings;
+    
+    if (!initializeRenderer(renderer, settings)) {
+        std::cerr << "✗ Cola de renders: no se pudo inicializar el renderer" << std::endl;
+        return false;
+    }
+    renderer.setOutputSamples(settings.samples);
+    
+    if (!loader.loadModel(job.inputFile, renderer)) {
+        std::cerr << "✗ Error al cargar el modelo: " << job.inputFile << std::endl;
+        return false;
+    }
+    
+    if (m_cancelCurrent) {
+        return false;
+    }
+    m_currentProgress = kLoadProgressShare;
+    
+    // Misma cámara que renderSingleFile y el lote de la línea de comandos
+    renderer.centerCamera();
+    renderer.setCameraOrbit(settings.cameraYaw, settings.cameraPitch, settings.cameraDistance);
+    
+    renderer.setBackgroundColor(settings.backgroundColor);
+    renderer.setModelColor(settings.modelColor);
+    
+    if (!renderer.renderToFile(job.outputFile, settings.transparentBackground)) {
+        std::cerr << "✗ Error al guardar la imagen: " << job.outputFile << std::endl;
+        return false;
+    }
+    
+    m_currentProgress = 1.0f;
+    std::cout << "✓ Imagen guardada: " << job.outputFile << std::endl;
+    return true;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include "renderer.h"
+#include "headless_context.h"
+
+class StlLoader;
+
+// Un STL y la imagen que hay que generar
+struct RenderJob {
+    std::string inputFile;
+    std::string outputFile;
+    RenderJobSettings settings;
+};
+
+// Resultado de un trabajo terminado (o cancelado)
+struct RenderJobResult {
+    std::string inputFile;
+    std::string outputFile;
+    bool success = false;
+    double seconds = 0.0;
+};
+
+// Estado agregado de la cola para mostrarlo en la interfaz
+struct RenderQueueStatus {
+    bool busy = false;
+    size_t pending = 0;
+    size_t completed = 0;
+    size_t failed = 0;
+    size_t total = 0;               // Trabajos de la tanda actual
+    std::string currentFile;
+    float currentProgress = 0.0f;   // Progreso del trabajo actual (0-1)
+    double filesPerSecond = 0.0;
+    double etaSeconds = 0.0;
+};
+
+// Cola de renders en segundo plano para la interfaz (carpetas y archivos arrastrados).
+// Un único hilo de trabajo con su propio Renderer y contexto sin ventana (EGL/OSMesa)
+// procesa los trabajos en orden; si no hay contexto disponible usa el rasterizador por CPU.
+// La ventana principal sigue respondiendo mientras tanto
+class RenderJobQueue {
+public:
+    RenderJobQueue();
+    ~RenderJobQueue();
+    
+    // Backend y proveedor de contexto con los que se crea el renderer del hilo
+    void setBackend(RenderBackend backend, HeadlessProvider provider);
+    
+    void enqueue(const RenderJob& job);
+    
+    // Descarta los trabajos pendientes e interrumpe el actual
+    void cancel();
+    
+    RenderQueueStatus getStatus() const;
+    std::vector<RenderJobResult> getResults() const;
+    void clearResults();
+    bool isBusy() const;
+
+private:
+    void workerLoop();
+    bool initializeRenderer(Renderer& renderer, const RenderJobSettings& settings);
+    bool runJob(Renderer& renderer, StlLoader& loader, const RenderJob& job);
+    
+    std::thread m_thread;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stop;
+    
+    RenderBackend m_backend;
+    HeadlessProvider m_provider;
+    
+    // Protegidos por m_mutex
+    std::deque<RenderJob> m_pending;
+    std::vector<RenderJobResult> m_results;
+    std::string m_currentFile;
+    bool m_working;
+    size_t m_batchTotal;
+    size_t m_batchCompleted;
+    size_t m_batchFailed;
+    std::chrono::steady_clock::time_point m_batchStart;
+    
+    // Escritos por el hilo de trabajo sin bloquear
+    std::atomic<float> m_currentProgress;
+    std::atomic<bool> m_cancelCurrent;
+};
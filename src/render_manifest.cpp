@@ -0,0 +1,247 @@
+#include "render_manifest.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <cstdlib>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Primera línea del archivo; si cambia el formato, los manifiestos viejos se ignoran
+const char* kManifestHeader = "# stlrender manifest v1";
+
+const uint64_t kFnvOffset = 14695981039346656037ULL;
+const uint64_t kFnvPrime = 1099511628211ULL;
+
+uint64_t fnv1a(const char* data, size_t length, uint64_t hash) {
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= kFnvPrime;
+    }
+    return hash;
+}
+
+std::string toHex(uint64_t value) {
+    std::ostringstream out;
+    out << std::hex << std::setw(16) << std::setfill('0') << value;
+    return out.str();
+}
+
+// Tamaño y fecha del STL; false si no se puede leer
+bool statFile(const fs::path& file, uintmax_t& size, long long& modified) {
+    std::error_code ec;
+    size = fs::file_size(file, ec);
+    if (ec) {
+        return false;
+    }
+    fs::file_time_type time = fs::last_write_time(file, ec);
+    if (ec) {
+        return false;
+    }
+    modified = static_cast<long long>(time.time_since_epoch().count());
+    return true;
+}
+
+} // namespace
+
+const char* RenderManifest::kFileName = ".stlrender_manifest.tsv";
+
+RenderManifest::RenderManifest(const std::string& path, const std::string& parameters)
+    : m_path(path)
+    , m_parameters(parameters)
+    , m_skipped(0)
+    , m_recorded(0)
+{
+}
+
+bool RenderManifest::load() {
+    std::ifstream file(m_path);
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    std::string line;
+    if (!std::getline(file, line) || line != kManifestHeader) {
+        std::cerr << "Manifiesto de otra versión, se renderiza todo de nuevo: " << m_path << std::endl;
+        return false;
+    }
+    
+    // clave \t tamaño \t fecha \t hash \t parámetros \t salida
+    std::lock_guard<std::mutex> lock(m_mutex);
+    while (std::getline(file, line)) {
+        std::vector<std::string> fields;
+        std::stringstream stream(line);
+        std::string field;
+        while (std::getline(stream, field, '\t')) {
+            fields.push_back(field);
+        }
+        if (fields.size() != 6) {
+            continue;
+        }
+        
+        ManifestEntry entry;
+        entry.size = std::strtoull(fields[1].c_str(), nullptr, 10);
+        entry.modified = std::strtoll(fields[2].c_str(), nullptr, 10);
+        entry.hash = fields[3];
+        entry.parameters = fields[4];
+        entry.outputFile = fields[5];
+        m_entries[fields[0]] = entry;
+    }
+    
+    std::cout << "Manifiesto cargado: " << m_entries.size() << " entradas (" << m_path << ")" << std::endl;
+    return true;
+}
+
+bool RenderManifest::save(bool dropUnseen) {
+    // Se escribe aparte y se renombra: un corte a medias no deja un manifiesto roto
+    std::string tempPath = m_path + ".tmp";
+    {
+        std::ofstream file(tempPath);
+        if (!file.is_open()) {
+            std::cerr << "Error: No se pudo escribir el manifiesto: " << tempPath << std::endl;
+            return false;
+        }
+        
+        file << kManifestHeader << '\n';
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& pair : m_entries) {
+            const ManifestEntry& entry = pair.second;
+            if (dropUnseen && !entry.seen) {
+                continue;
+            }
+            file << pair.first << '\t' << entry.size << '\t' << entry.modified << '\t' << entry.hash
+                 << '\t' << entry.parameters << '\t' << entry.outputFile << '\n';
+        }
+        
+        if (!file) {
+            std::cerr << "Error: No se pudo escribir el manifiesto: " << tempPath << std::endl;
+            return false;
+        }
+    }
+    
+    std::error_code ec;
+    fs::rename(tempPath, m_path, ec);
+    if (ec) {
+        std::cerr << "Error: No se pudo reemplazar el manifiesto: " << m_path << " (" << ec.message() << ")" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool RenderManifest::isUpToDate(const std::string& key, const fs::path& source, const std::string& outputFile) {
+    ManifestEntry entry;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(key);
+        if (it == m_entries.end()) {
+            return false;
+        }
+        
+        // Si el archivo se vuelve a renderizar, record lo sustituye; si falla, la entrada
+        // vieja se conserva y el próximo lote lo vuelve a intentar
+        it->second.seen = true;
+        entry = it->second;
+    }
+    
+    if (entry.parameters != m_parameters || entry.outputFile != outputFile) {
+        return false;
+    }
+    
+    uintmax_t size = 0;
+    long long modified = 0;
+    std::error_code ec;
+    if (!statFile(source, size, modified) || size != entry.size || !fs::exists(outputFile, ec)) {
+        return false;
+    }
+    
+    if (modified != entry.modified) {
+        // Fecha distinta con el mismo tamaño (copiado, tocado): decide el contenido
+        if (hashFile(source.string()) != entry.hash) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries[key].modified = modified;
+    }
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_skipped++;
+    return true;
+}
+
+void RenderManifest::record(const std::string& key, const SourceStamp& source, const std::string& outputFile) {
+    // Sin sello fiable no se anota: el próximo lote lo vuelve a renderizar
+    if (!source.valid) {
+        return;
+    }
+    
+    ManifestEntry entry;
+    entry.size = source.size;
+    entry.modified = source.modified;
+    entry.hash = source.hash;
+    entry.parameters = m_parameters;
+    entry.outputFile = outputFile;
+    entry.seen = true;
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries[key] = entry;
+    m_recorded++;
+}
+
+size_t RenderManifest::getSkipped() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_skipped;
+}
+
+size_t RenderManifest::getRecorded() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_recorded;
+}
+
+std::string RenderManifest::describeSettings(const RenderJobSettings& settings, const std::string& backend) {
+    std::ostringstream description;
+    description << settings.width << 'x' << settings.height
+                << " samples " << settings.samples
+                << " model " << settings.modelColor.r << ',' << settings.modelColor.g << ',' << settings.modelColor.b
+                << " background " << settings.backgroundColor.r << ',' << settings.backgroundColor.g << ',' << settings.backgroundColor.b
+                << " transparent " << settings.transparentBackground
+                << " camera " << settings.cameraYaw << ',' << settings.cameraPitch << ',' << settings.cameraDistance
+                << " backend " << backend;
+    
+    // En el manifiesto solo va el hash: la descripción se repetiría en cada línea
+    std::string text = description.str();
+    return toHex(fnv1a(text.data(), text.size(), kFnvOffset));
+}
+
+SourceStamp RenderManifest::stampFile(const std::string& path) {
+    SourceStamp stamp;
+    if (!statFile(path, stamp.size, stamp.modified)) {
+        return stamp;
+    }
+    stamp.hash = hashFile(path);
+    stamp.valid = !stamp.hash.empty() && isStampCurrent(path, stamp);
+    return stamp;
+}
+
+bool RenderManifest::isStampCurrent(const std::string& path, const SourceStamp& stamp) {
+    uintmax_t size = 0;
+    long long modified = 0;
+    return statFile(path, size, modified) && size == stamp.size && modified == stamp.modified;
+}
+
+std::string RenderManifest::hashFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return "";
+    }
+    
+    uint64_t hash = kFnvOffset;
+    std::vector<char> buffer(1 << 16);
+    while (file) {
+        file.read(buffer.data(), buffer.size());
+        hash = fnv1a(buffer.data(), static_cast<size_t>(file.gcount()), hash);
+    }
+    return toHex(hash);
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <filesystem>
+#include "render_job_queue.h"
+
+// Estado de un STL la última vez que se renderizó
+struct ManifestEntry {
+    uintmax_t size = 0;
+    long long modified = 0;         // last_write_time del STL (unidades del reloj del sistema de archivos)
+    std::string hash;               // FNV-1a del contenido del STL
+    std::string parameters;         // Huella de los parámetros de render
+    std::string outputFile;
+    bool seen = false;              // Visto en este lote; los demás se descartan al guardar
+};
+
+// Tamaño, fecha y hash de un STL tomados cuando se leyó para renderizarlo; lo que se
+// anota en el manifiesto corresponde a la imagen aunque el archivo cambie después
+struct SourceStamp {
+    uintmax_t size = 0;
+    long long modified = 0;
+    std::string hash;
+    bool valid = false;             // false si no se pudo leer o cambió mientras se cargaba
+};
+
+// Manifiesto de una carpeta renderizada, guardado junto a las salidas. Un archivo se
+// omite si su entrada coincide en tamaño y fecha (o, si solo cambió la fecha, en el
+// hash del contenido), en parámetros de render y en salida, y el PNG sigue existiendo.
+// Las claves son rutas relativas a la carpeta, así que el catálogo se puede mover.
+// Seguro desde varios hilos (el escáner consulta y los codificadores registran)
+class RenderManifest {
+public:
+    RenderManifest(const std::string& path, const std::string& parameters);
+    
+    // Un manifiesto ausente o de otra versión equivale a uno vacío
+    bool load();
+    
+    // dropUnseen = false conserva también lo que no se vio (lotes parciales, vigilancia)
+    bool save(bool dropUnseen = true);
+    
+    bool isUpToDate(const std::string& key, const std::filesystem::path& source, const std::string& outputFile);
+    void record(const std::string& key, const SourceStamp& source, const std::string& outputFile);
+    
+    size_t getSkipped() const;
+    size_t getRecorded() const;
+    
+    // Huella de todo lo que cambia la imagen resultante
+    static std::string describeSettings(const RenderJobSettings& settings, const std::string& backend);
+    static std::string hashFile(const std::string& path);
+    
+    // stampFile antes de cargar el STL; isStampCurrent después, para descartar el sello
+    // si el archivo se modificó durante la carga
+    static SourceStamp stampFile(const std::string& path);
+    static bool isStampCurrent(const std::string& path, const SourceStamp& stamp);
+    
+    static const char* kFileName;
+
+private:
+    std::string m_path;
+    std::string m_parameters;
+    
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, ManifestEntry> m_entries;
+    size_t m_skipped;
+    size_t m_recorded;
+};
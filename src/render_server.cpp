@@ -0,0 +1,643 @@
+// En Windows winsock2.h tiene que ir antes que cualquier inclusión de windows.h
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#endif
+
+#include "render_server.h"
+#include "renderer.h"
+#include "stl_loader.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <poll.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+#ifdef _WIN32
+typedef SOCKET SocketHandle;
+const SocketHandle kInvalidSocket = INVALID_SOCKET;
+#else
+typedef int SocketHandle;
+const SocketHandle kInvalidSocket = -1;
+#endif
+
+// Espera máxima de cada vuelta de accept y del render (para ver si hay que parar)
+const int kStopCheckMs = 200;
+
+// Un cliente que deja de enviar no retiene su hueco para siempre
+const int kClientTimeoutSeconds = 10;
+
+// Cabeceras HTTP más largas que esto se rechazan
+const size_t kMaxHeaderBytes = 16 * 1024;
+
+long currentProcessId() {
+#ifdef _WIN32
+    return static_cast<long>(GetCurrentProcessId());
+#else
+    return static_cast<long>(getpid());
+#endif
+}
+
+void closeSocket(SocketHandle socket) {
+#ifdef _WIN32
+    closesocket(socket);
+#else
+    close(socket);
+#endif
+}
+
+bool sendAll(SocketHandle socket, const char* data, size_t length) {
+    while (length > 0) {
+#ifdef _WIN32
+        int sent = send(socket, data, static_cast<int>(std::min<size_t>(length, 1 << 30)), 0);
+#elif defined(MSG_NOSIGNAL)
+        // Un cliente que cierra antes de tiempo no debe matar al servidor con SIGPIPE
+        ssize_t sent = send(socket, data, length, MSG_NOSIGNAL);
+#else
+        ssize_t sent = send(socket, data, length, 0);
+#endif
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        length -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+bool sendResponse(SocketHandle socket, int status, const std::string& contentType, const char* body, size_t length,
+                  const std::string& extraHeaders = "") {
+    const char* reason = status == 200 ? "OK" : status == 400 ? "Bad Request" : status == 404 ? "Not Found" :
+                         status == 413 ? "Payload Too Large" : status == 503 ? "Service Unavailable" : "Internal Server Error";
+    
+    std::ostringstream header;
+    header << "HTTP/1.1 " << status << " " << reason << "\r\n"
+           << "Content-Type: " << contentType << "\r\n"
+           << "Content-Length: " << length << "\r\n"
+           << extraHeaders
+           << "Connection: close\r\n\r\n";
+    std::string text = header.str();
+    return sendAll(socket, text.data(), text.size()) && sendAll(socket, body, length);
+}
+
+bool sendText(SocketHandle socket, int status, const std::string& text) {
+    std::string body = text + "\n";
+    return sendResponse(socket, status, "text/plain; charset=utf-8", body.data(), body.size());
+}
+
+std::string urlDecode(const std::string& value) {
+    std::string decoded;
+    for (size_t i = 0; i < value.size(); ++i) {
+        if (value[i] == '+') {
+            decoded += ' ';
+        } else if (value[i] == '%' && i + 2 < value.size() &&
+                   std::isxdigit(static_cast<unsigned char>(value[i + 1])) && std::isxdigit(static_cast<unsigned char>(value[i + 2]))) {
+            decoded += static_cast<char>(std::strtol(value.substr(i + 1, 2).c_str(), nullptr, 16));
+            i += 2;
+        } else {
+            decoded += value[i];
+        }
+    }
+    return decoded;
+}
+
+// "r,g,b" con valores entre 0 y 1
+bool parseColor(const std::string& value, Color& color) {
+    float r = 0.0f, g = 0.0f, b = 0.0f;
+    char comma1 = 0, comma2 = 0;
+    std::istringstream stream(value);
+    if (!(stream >> r >> comma1 >> g >> comma2 >> b) || comma1 != ',' || comma2 != ',') {
+        return false;
+    }
+    color = Color(r, g, b);
+    return true;
+}
+
+} // namespace
+
+RenderServer::RenderServer(Renderer& renderer, const RenderServerSettings& settings)
+    : m_renderer(renderer)
+    , m_settings(settings)
+    , m_stopping(false)
+    , m_listener(static_cast<long long>(kInvalidSocket))
+    , m_activeClients(0)
+    , m_reservedSlots(0)
+    , m_served(0)
+    , m_rejected(0)
+    , m_nextUpload(0)
+{
+}
+
+RenderServer::~RenderServer() {
+    m_stopping = true;
+    if (m_acceptThread.joinable()) {
+        m_acceptThread.join();
+    }
+    closeListener();
+}
+
+bool RenderServer::run(const std::function<bool()>& shouldStop) {
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        std::cerr << "Error: No se pudo iniciar Winsock" << std::endl;
+        return false;
+    }
+#endif
+
+    if (!listen()) {
+        return false;
+    }
+    
+    m_stopping = false;
+    m_acceptThread = std::thread(&RenderServer::acceptLoop, this);
+    std::cout << "Servidor de renders escuchando en " << m_settings.address << " (" << m_settings.maxClients
+              << " conexiones, cola de " << m_settings.queueDepth << ")" << std::endl;
+    
+    // Bucle de render: el contexto OpenGL es de este hilo
+    while (!shouldStop()) {
+        std::shared_ptr<RenderTask> task;
+        if (popTask(task)) {
+            renderTask(*task);
+        }
+    }
+    
+    std::cout << "Deteniendo el servidor de renders..." << std::endl;
+    m_stopping = true;
+    if (m_acceptThread.joinable()) {
+        m_acceptThread.join();
+    }
+    
+    // Lo que quedaba en cola se responde con error para liberar a sus conexiones
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        for (auto* queue : { &m_interactive, &m_batch }) {
+            for (auto& task : *queue) {
+                RenderResult result;
+                result.error = "servidor detenido";
+                task->result.set_value(std::move(result));
+            }
+            queue->clear();
+        }
+    }
+    
+    std::unique_lock<std::mutex> lock(m_clientsMutex);
+    m_clientsDone.wait(lock, [this]() { return m_activeClients == 0; });
+    lock.unlock();
+    
+    closeListener();
+#ifdef _WIN32
+    WSACleanup();
+#endif
+
+    std::cout << "Servidor de renders detenido: " << m_served.load() << " renders servidos, "
+              << m_rejected.load() << " peticiones rechazadas por carga" << std::endl;
+    return true;
+}
+
+bool RenderServer::listen() {
+    SocketHandle listener = kInvalidSocket;
+    const std::string& address = m_settings.address;
+
+#ifndef _WIN32
+    if (address.find('/') != std::string::npos) {
+        sockaddr_un local;
+        std::memset(&local, 0, sizeof(local));
+        local.sun_family = AF_UNIX;
+        if (address.size() >= sizeof(local.sun_path)) {
+            std::cerr << "Error: Ruta de socket demasiado larga: " << address << std::endl;
+            return false;
+        }
+        std::strncpy(local.sun_path, address.c_str(), sizeof(local.sun_path) - 1);
+        
+        // Un socket que quedó de una ejecución anterior impediría el bind
+        ::unlink(address.c_str());
+        listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener == kInvalidSocket || bind(listener, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0) {
+            std::cerr << "Error: No se pudo crear el socket Unix " << address << std::endl;
+            if (listener != kInvalidSocket) {
+                closeSocket(listener);
+            }
+            return false;
+        }
+        m_unixPath = address;
+    }
+#endif
+
+    if (listener == kInvalidSocket) {
+        // [host:]puerto; por defecto solo la propia máquina
+        std::string host = "127.0.0.1";
+        std::string port = address;
+        size_t colon = address.rfind(':');
+        if (colon != std::string::npos) {
+            host = address.substr(0, colon);
+            port = address.substr(colon + 1);
+        }
+        
+        sockaddr_in local;
+        std::memset(&local, 0, sizeof(local));
+        local.sin_family = AF_INET;
+        local.sin_port = htons(static_cast<unsigned short>(std::atoi(port.c_str())));
+        if (local.sin_port == 0 || inet_pton(AF_INET, host.c_str(), &local.sin_addr) != 1) {
+            std::cerr << "Error: Dirección no válida para --serve: " << address << std::endl;
+            return false;
+        }
+        
+        // Sin autenticación y con path/output sobre el disco: solo la propia máquina
+        if ((ntohl(local.sin_addr.s_addr) >> 24) != 127) {
+            std::cerr << "Error: --serve solo escucha en direcciones locales (127.x.x.x): " << address << std::endl;
+            return false;
+        }
+        
+        listener = socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        if (listener != kInvalidSocket) {
+            setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+        }
+        if (listener == kInvalidSocket || bind(listener, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0) {
+            std::cerr << "Error: No se pudo escuchar en " << host << ":" << port << std::endl;
+            if (listener != kInvalidSocket) {
+                closeSocket(listener);
+            }
+            return false;
+        }
+    }
+    
+    if (::listen(listener, SOMAXCONN) != 0) {
+        std::cerr << "Error: listen falló en " << address << std::endl;
+        closeSocket(listener);
+        return false;
+    }
+    
+    m_listener = static_cast<long long>(listener);
+    return true;
+}
+
+void RenderServer::closeListener() {
+    SocketHandle listener = static_cast<SocketHandle>(m_listener);
+    if (listener != kInvalidSocket) {
+        closeSocket(listener);
+        m_listener = static_cast<long long>(kInvalidSocket);
+    }
+#ifndef _WIN32
+    if (!m_unixPath.empty()) {
+        ::unlink(m_unixPath.c_str());
+        m_unixPath.clear();
+    }
+#endif
+}
+
+void RenderServer::acceptLoop() {
+    SocketHandle listener = static_cast<SocketHandle>(m_listener);
+    
+    while (!m_stopping) {
+#ifdef _WIN32
+        WSAPOLLFD descriptor;
+        descriptor.fd = listener;
+        descriptor.events = POLLRDNORM;
+        descriptor.revents = 0;
+        if (WSAPoll(&descriptor, 1, kStopCheckMs) <= 0) {
+            continue;
+        }
+#else
+        pollfd descriptor;
+        descriptor.fd = listener;
+        descriptor.events = POLLIN;
+        descriptor.revents = 0;
+        if (::poll(&descriptor, 1, kStopCheckMs) <= 0) {
+            continue;
+        }
+#endif
+
+        SocketHandle client = accept(listener, nullptr, nullptr);
+        if (client == kInvalidSocket) {
+            continue;
+        }
+        
+        // Sin esperar indefinidamente a un cliente lento
+#ifdef _WIN32
+        DWORD timeout = kClientTimeoutSeconds * 1000;
+#else
+        timeval timeout;
+        timeout.tv_sec = kClientTimeoutSeconds;
+        timeout.tv_usec = 0;
+#endif
+        setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+        
+        {
+            std::lock_guard<std::mutex> lock(m_clientsMutex);
+            if (m_activeClients >= m_settings.maxClients) {
+                m_rejected++;
+                sendText(client, 503, "demasiadas conexiones");
+                closeSocket(client);
+                continue;
+            }
+            m_activeClients++;
+        }
+        
+        std::thread(&RenderServer::handleClient, this, static_cast<long long>(client)).detach();
+    }
+}
+
+void RenderServer::handleClient(long long clientHandle) {
+    SocketHandle client = static_cast<SocketHandle>(clientHandle);
+    auto start = std::chrono::steady_clock::now();
+    
+    // Cabeceras hasta la línea vacía; lo que sobra ya es parte del cuerpo
+    std::string data;
+    size_t headerEnd = std::string::npos;
+    char buffer[16 * 1024];
+    while (headerEnd == std::string::npos && data.size() < kMaxHeaderBytes) {
+        int received = static_cast<int>(recv(client, buffer, sizeof(buffer), 0));
+        if (received <= 0) {
+            break;
+        }
+        data.append(buffer, received);
+        headerEnd = data.find("\r\n\r\n");
+    }
+    
+    auto finish = [this, client]() {
+        closeSocket(client);
+        std::lock_guard<std::mutex> lock(m_clientsMutex);
+        m_activeClients--;
+        m_clientsDone.notify_all();
+    };
+    
+    if (headerEnd == std::string::npos) {
+        sendText(client, 400, "petición incompleta");
+        finish();
+        return;
+    }
+    
+    std::istringstream headers(data.substr(0, headerEnd));
+    std::string method, target, version, line;
+    headers >> method >> target >> version;
+    std::getline(headers, line);
+    
+    size_t contentLength = 0;
+    while (std::getline(headers, line)) {
+        std::string lower = line;
+        std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (lower.compare(0, 15, "content-length:") == 0) {
+            contentLength = static_cast<size_t>(std::strtoull(line.c_str() + 15, nullptr, 10));
+        }
+    }
+    
+    std::string path = target.substr(0, target.find('?'));
+    std::string query = target.find('?') != std::string::npos ? target.substr(target.find('?') + 1) : "";
+    
+    if (method == "GET" && path == "/health") {
+        size_t queued = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            queued = m_interactive.size() + m_batch.size();
+        }
+        std::ostringstream status;
+        status << "ok cola=" << queued << " servidos=" << m_served.load() << " rechazados=" << m_rejected.load();
+        sendText(client, 200, status.str());
+        finish();
+        return;
+    }
+    
+    if (method != "POST" || path != "/render") {
+        sendText(client, 404, "usar POST /render o GET /health");
+        finish();
+        return;
+    }
+    
+    // Parámetros de la consulta sobre los valores por defecto del servidor
+    std::shared_ptr<RenderTask> task = std::make_shared<RenderTask>();
+    task->settings = m_settings.defaults;
+    RenderPriority priority = RenderPriority::Interactive;
+    std::string inputFile;
+    std::string outputFile;
+    bool rawPixels = false;
+    bool valid = true;
+    
+    std::stringstream pairs(query);
+    std::string pair;
+    while (std::getline(pairs, pair, '&')) {
+        size_t equals = pair.find('=');
+        std::string key = urlDecode(pair.substr(0, equals));
+        std::string value = equals != std::string::npos ? urlDecode(pair.substr(equals + 1)) : "";
+        
+        if (key == "path") {
+            inputFile = value;
+        } else if (key == "output") {
+            outputFile = value;
+        } else if (key == "width") {
+            task->settings.width = std::atoi(value.c_str());
+        } else if (key == "height") {
+            task->settings.height = std::atoi(value.c_str());
+        } else if (key == "yaw") {
+            task->settings.cameraYaw = static_cast<float>(std::atof(value.c_str()));
+        } else if (key == "pitch") {
+            task->settings.cameraPitch = static_cast<float>(std::atof(value.c_str()));
+        } else if (key == "distance") {
+            task->settings.cameraDistance = static_cast<float>(std::atof(value.c_str()));
+        } else if (key == "samples") {
+            task->settings.samples = std::max(1, std::atoi(value.c_str()));
+        } else if (key == "transparent") {
+            task->settings.transparentBackground = (value == "1" || value == "true");
+        } else if (key == "color") {
+            valid = parseColor(value, task->settings.modelColor) && valid;
+        } else if (key == "background") {
+            valid = parseColor(value, task->settings.backgroundColor) && valid;
+        } else if (key == "priority") {
+            priority = value == "batch" ? RenderPriority::Batch : RenderPriority::Interactive;
+        } else if (key == "format") {
+            rawPixels = value == "raw";
+            valid = (value == "raw" || value == "png") && valid;
+        }
+    }
+    
+    if (!valid || task->settings.width <= 0 || task->settings.height <= 0 ||
+        task->settings.width > m_settings.maxOutputSize || task->settings.height > m_settings.maxOutputSize) {
+        sendText(client, 400, "parámetros no válidos (tamaño máximo " + std::to_string(m_settings.maxOutputSize) + ")");
+        finish();
+        return;
+    }
+    
+    // Hueco en la cola antes de leer el cuerpo y cargar: con el servidor saturado se
+    // responde 503 sin decodificar la malla
+    if (!reserveSlot()) {
+        m_rejected++;
+        sendText(client, 503, "cola de renders llena");
+        finish();
+        return;
+    }
+    
+    // Sin ruta, el STL viene en el cuerpo
+    std::string uploadPath;
+    if (inputFile.empty()) {
+        if (contentLength == 0 || contentLength > m_settings.maxBodyBytes) {
+            releaseSlot();
+            sendText(client, contentLength == 0 ? 400 : 413, "falta path o el STL en el cuerpo");
+            finish();
+            return;
+        }
+        
+        std::string body = data.substr(headerEnd + 4);
+        while (body.size() < contentLength) {
+            int received = static_cast<int>(recv(client, buffer, sizeof(buffer), 0));
+            if (received <= 0) {
+                break;
+            }
+            body.append(buffer, received);
+        }
+        if (body.size() < contentLength) {
+            releaseSlot();
+            sendText(client, 400, "cuerpo incompleto");
+            finish();
+            return;
+        }
+        
+        // El cargador lee de archivo: el cuerpo pasa por un temporal
+        uploadPath = (fs::temp_directory_path() / ("stlrender_upload_" + std::to_string(currentProcessId()) + "_" +
+                                                     std::to_string(m_nextUpload++) + ".stl")).string();
+        std::ofstream upload(uploadPath, std::ios::binary);
+        upload.write(body.data(), static_cast<std::streamsize>(contentLength));
+        upload.close();
+        inputFile = uploadPath;
+    }
+    
+    // Carga en este hilo, en paralelo con el render de otras peticiones
+    StlLoader loader;
+    bool loaded = loader.loadFile(inputFile);
+    if (!uploadPath.empty()) {
+        std::error_code ec;
+        fs::remove(uploadPath, ec);
+    }
+    if (!loaded) {
+        releaseSlot();
+        sendText(client, 400, "no se pudo cargar el STL");
+        finish();
+        return;
+    }
+    task->model = loader.releaseModel();
+    
+    std::future<RenderResult> pending = task->result.get_future();
+    if (!enqueue(task, priority)) {
+        m_rejected++;
+        sendText(client, 503, "servidor detenido");
+        finish();
+        return;
+    }
+    RenderResult result = pending.get();
+    
+    if (!result.success) {
+        sendText(client, 500, "error al renderizar: " + result.error);
+        finish();
+        return;
+    }
+    
+    std::ostringstream timing;
+    timing << "X-Render-Ms: " << result.renderMs << "\r\n"
+           << "X-Total-Ms: " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() << "\r\n";
+    
+    const RenderedImage& image = result.image;
+    if (rawPixels && outputFile.empty()) {
+        // Píxeles sin comprimir: quien los recibe conoce el formato por las cabeceras
+        timing << "X-Image-Width: " << image.width << "\r\n"
+               << "X-Image-Height: " << image.height << "\r\n"
+               << "X-Image-Channels: " << image.channels << "\r\n";
+        sendResponse(client, 200, "application/octet-stream", reinterpret_cast<const char*>(image.data.data()),
+                     image.data.size(), timing.str());
+        finish();
+        return;
+    }
+    
+    // El PNG se comprime aquí y no en el hilo de OpenGL, que ya atiende la siguiente petición
+    std::vector<unsigned char> png;
+    if (!outputFile.empty()) {
+        if (!Renderer::writePng(outputFile, image.data.data(), image.width, image.height, image.channels)) {
+            sendText(client, 500, "no se pudo escribir " + outputFile);
+        } else {
+            std::string body = outputFile + "\n";
+            sendResponse(client, 200, "text/plain; charset=utf-8", body.data(), body.size(), timing.str());
+        }
+    } else if (!Renderer::encodePng(image.data.data(), image.width, image.height, image.channels, png)) {
+        sendText(client, 500, "no se pudo codificar el PNG");
+    } else {
+        sendResponse(client, 200, "image/png", reinterpret_cast<const char*>(png.data()), png.size(), timing.str());
+    }
+    
+    finish();
+}
+
+bool RenderServer::reserveSlot() {
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    if (m_stopping || static_cast<int>(m_interactive.size() + m_batch.size()) + m_reservedSlots >= m_settings.queueDepth) {
+        return false;
+    }
+    m_reservedSlots++;
+    return true;
+}
+
+void RenderServer::releaseSlot() {
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    m_reservedSlots--;
+}
+
+// Ocupa el hueco reservado con reserveSlot
+bool RenderServer::enqueue(const std::shared_ptr<RenderTask>& task, RenderPriority priority) {
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_reservedSlots--;
+        if (m_stopping) {
+            return false;
+        }
+        (priority == RenderPriority::Interactive ? m_interactive : m_batch).push_back(task);
+    }
+    m_queueReady.notify_one();
+    return true;
+}
+
+bool RenderServer::popTask(std::shared_ptr<RenderTask>& task) {
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+    m_queueReady.wait_for(lock, std::chrono::milliseconds(kStopCheckMs),
+                          [this]() { return !m_interactive.empty() || !m_batch.empty(); });
+    
+    // Las interactivas adelantan a todo el lote pendiente
+    std::deque<std::shared_ptr<RenderTask>>& queue = !m_interactive.empty() ? m_interactive : m_batch;
+    if (queue.empty()) {
+        return false;
+    }
+    task = std::move(queue.front());
+    queue.pop_front();
+    return true;
+}
+
+void RenderServer::renderTask(RenderTask& task) {
+    auto start = std::chrono::steady_clock::now();
+    RenderResult result;
+    
+    // El contexto ya existe: solo se aplican los ajustes de la petición. Los píxeles se
+    // comprimen en el hilo de la conexión
+    result.success = m_renderer.renderImage(std::move(task.model), task.settings, result.image, ImageEncoding::Raw);
+    if (!result.success) {
+        result.error = m_renderer.needsTiledOutput() ? "tamaño de salida demasiado grande" : "fallo del renderer";
+    } else {
+        m_served++;
+    }
+    
+    result.renderMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    task.result.set_value(std::move(result));
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <thread>
+#include <functional>
+#include <condition_variable>
+#include "model.h"
+#include "render_job_queue.h"
+
+class Renderer;
+
+// Parámetros del servidor de renders (--serve)
+struct RenderServerSettings {
+    std::string address;            // Ruta de socket Unix (contiene '/') o [host:]puerto TCP (solo 127.x.x.x)
+    RenderJobSettings defaults;     // Lo que la petición no indique
+    int maxClients = 32;            // Conexiones atendidas a la vez; las demás reciben 503
+    int queueDepth = 64;            // Renders esperando a la GPU; con la cola llena, 503
+    int maxOutputSize = 4096;       // Lado máximo de imagen que se acepta
+    size_t maxBodyBytes = 256u * 1024u * 1024u;  // STL enviado en el cuerpo
+};
+
+// Las interactivas (miniaturas de la tienda) se atienden antes que las de lote
+enum class RenderPriority {
+    Interactive,
+    Batch
+};
+
+// Servidor HTTP/1.1 mínimo sobre un socket Unix o TCP local. Cada conexión tiene su hilo:
+// lee la petición y carga el STL (ruta o bytes en el cuerpo) en paralelo con las demás, y
+// comprime el PNG al terminar. El render se hace en el hilo que llama a run, dueño del
+// contexto OpenGL, que ya está creado entre peticiones. Una petición por conexión:
+//   POST /render?path=...&width=256&height=256&priority=interactive  -> image/png
+//   POST /render?output=/ruta/salida.png   (cuerpo: bytes del STL)    -> ruta de salida
+//   GET  /health                                                       -> estado de la cola
+// Otros parámetros: yaw, pitch, distance, color=r,g,b, background=r,g,b, transparent, samples,
+// format=raw (píxeles sin comprimir; tamaño y canales en X-Image-Width/Height/Channels)
+class RenderServer {
+public:
+    RenderServer(Renderer& renderer, const RenderServerSettings& settings);
+    ~RenderServer();
+    
+    // Atiende peticiones hasta que shouldStop devuelva true; false si no pudo escuchar
+    bool run(const std::function<bool()>& shouldStop);
+
+private:
+    struct RenderResult {
+        bool success = false;
+        std::string error;
+        RenderedImage image;        // Píxeles sin comprimir
+        double renderMs = 0.0;
+    };
+    
+    struct RenderTask {
+        RenderJobSettings settings;
+        Model model;
+        std::promise<RenderResult> result;
+    };
+    
+    bool listen();
+    void closeListener();
+    void acceptLoop();
+    void handleClient(long long client);
+    bool reserveSlot();
+    void releaseSlot();
+    bool enqueue(const std::shared_ptr<RenderTask>& task, RenderPriority priority);
+    bool popTask(std::shared_ptr<RenderTask>& task);
+    void renderTask(RenderTask& task);
+    
+    Renderer& m_renderer;
+    RenderServerSettings m_settings;
+    std::atomic<bool> m_stopping;
+    
+    long long m_listener;           // SOCKET en Windows, descriptor en POSIX
+    std::string m_unixPath;         // Se borra al terminar
+    std::thread m_acceptThread;
+    
+    // Conexiones en curso (cada una en su propio hilo, desacoplado)
+    std::mutex m_clientsMutex;
+    std::condition_variable m_clientsDone;
+    int m_activeClients;
+    
+    // Renders pendientes por prioridad
+    std::mutex m_queueMutex;
+    std::condition_variable m_queueReady;
+    std::deque<std::shared_ptr<RenderTask>> m_interactive;
+    std::deque<std::shared_ptr<RenderTask>> m_batch;
+    int m_reservedSlots;            // Conexiones cargando su STL con el hueco de la cola ya asegurado
+    
+    std::atomic<size_t> m_served;
+    std::atomic<size_t> m_rejected;
+    std::atomic<unsigned> m_nextUpload;
+};
@@ -1,13 +1,12 @@
 #include "renderer.h"
 #include "stl_loader.h"
+#include "software_rasterizer.h"
+#include "png_stream_writer.h"
 
 // Incluir glad primero
 #include <glad/glad.h>
-#include <GLFW/glfw3.h>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
-#include <imgui.h>
-#include <imgui_internal.h> // Para ImGuiContext
 
 // Definir GL_SCISSOR_TEST si no está disponible
 #ifndef GL_SCISSOR_TEST
@@ -25,6 +24,25 @@
 #include <iostream>
 #include <vector>
 #include <fstream>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cmath>
+#include <filesystem>
+#include <limits>
+
+// Por encima de estos píxeles la salida se renderiza por tiles y se escribe por bandas
+const long long kTiledOutputPixels = 8192LL * 8192LL;
+
+// Lado máximo de cada tile del modo póster
+const int kPosterTileSize = 2048;
+
+// Destino de stbi_write_png_to_func para los PNG en memoria
+static void appendPngBytes(void* context, void* data, int size) {
+    auto* png = static_cast<std::vector<unsigned char>*>(context);
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    png->insert(png->end(), bytes, bytes + size);
+}
 
 // Shaders
 const char* vertexShaderSource = R"(
@@ -86,12 +104,24 @@ Renderer::Renderer()
     , m_width(1024)
     , m_height(1024)
     , m_headless(false)
+    , m_vertexCount(0)
+    , m_progressiveCapacity(0)
+    , m_uploadedTriangles(0)
     , m_vao(0)
     , m_vbo(0)
     , m_shader(nullptr)
-    , m_fbo(0)
-    , m_colorAttachment(0)
-    , m_depthAttachment(0)
+    , m_outputSamples(1)
+    , m_previewFbo(0)
+    , m_previewTexture(0)
+    , m_previewDepth(0)
+    , m_modelRevision(0)
+    , m_atlasWidth(0)
+    , m_atlasHeight(0)
+    , m_atlasTileWidth(0)
+    , m_atlasTileHeight(0)
+    , m_atlasColumns(0)
+    , m_atlasRows(0)
+    , m_atlasTransparent(false)
     , m_backgroundColor(0.0f, 0.0f, 0.0f)
     , m_modelColor(0.7f, 0.7f, 0.7f)
     , m_cameraPos(0.0f, 0.0f, 5.0f)
@@ -101,6 +131,11 @@ Renderer::Renderer()
     , m_cameraDistance(5.0f)
     , m_hasModel(false)
     , m_initialized(false)
+    , m_backend(RenderBackend::OpenGL)
+    , m_headlessProvider(HeadlessProvider::Auto)
+    , m_allowWindowFallback(true)
+    , m_contextInitCount(0)
+    , m_contextInitMs(0.0)
     , m_defaultCubeVAO(0)
     , m_defaultCubeVBO(0)
 {
@@ -112,11 +147,9 @@ Renderer::Renderer()
 Renderer::~Renderer() {
     destroyGLResources();
     
-    // Terminar GLFW
-    if (m_window) {
-        glfwDestroyWindow(m_window);
-        glfwTerminate();
-    }
+    // El contexto (y la ventana, si la hay) se libera después de los recursos GL
+    m_context.reset();
+    m_window = nullptr;
 }
 
 bool Renderer::initialize(int width, int height, bool headless) {
@@ -124,36 +157,19 @@ bool Renderer::initialize(int width, int height, bool headless) {
     m_height = height;
     m_headless = headless;
     
-    // Inicializar GLFW
-    if (!glfwInit()) {
-        std::cerr << "Error al inicializar GLFW" << std::endl;
-        return false;
-    }
-    
-    // Configurar opciones de GLFW
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-    
-    // Crear ventana
-    m_window = glfwCreateWindow(width, height, "STL Renderer", NULL, NULL);
-    if (!m_window) {
-        std::cerr << "Error al crear ventana GLFW" << std::endl;
-        glfwTerminate();
+    // Crear ventana (la aporta el ejecutable; la biblioteca no enlaza GLFW)
+    m_context = HeadlessContext::createWindow(width, height, true);
+    if (!m_context) {
+        std::cerr << "Error al crear la ventana: no hay sistema de ventanas disponible" << std::endl;
         return false;
     }
-    
-    // Hacer el contexto actual
-    glfwMakeContextCurrent(m_window);
-    
-    // Activar VSync para evitar parpadeo
-    glfwSwapInterval(1);
+    m_window = static_cast<GLFWwindow*>(m_context->getNativeWindow());
     
     // Cargar funciones de OpenGL con GLAD
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+    if (!m_context->loadGL()) {
         std::cerr << "Error al inicializar GLAD" << std::endl;
-        glfwDestroyWindow(m_window);
-        glfwTerminate();
+        m_context.reset();
+        m_window = nullptr;
         return false;
     }
     
@@ -184,38 +200,76 @@ bool Renderer::initialize(int width, int height, bool headless) {
 }
 
 bool Renderer::initializeHeadless(int width, int height) {
+    // Contexto ya creado: se reutiliza y solo se reinicia la escena. Crear el
+    // contexto, cargar GLAD y compilar shaders cuesta más que renderizar un STL pequeño
+    if (m_initialized && m_headless) {
+        if (width != m_width || height != m_height) {
+            setOutputSize(width, height);
+        }
+        resetScene();
+        return true;
+    }
+    
+    auto initStart = std::chrono::steady_clock::now();
+    
     m_width = width;
     m_height = height;
     m_headless = true;
     
     std::cout << "Inicializando renderer en modo headless: " << width << "x" << height << std::endl;
     
-    // Inicializar GLFW
-    if (!glfwInit()) {
-        std::cerr << "Error al inicializar GLFW en modo headless" << std::endl;
-        return false;
+    // El rasterizador por CPU no necesita ventana ni contexto OpenGL
+    if (m_backend == RenderBackend::Software) {
+        m_softwareRasterizer = std::make_unique<SoftwareRasterizer>();
+        
+        float aspectRatio = (float)width / (float)height;
+        m_projectionMatrix = glm::perspective(glm::radians(45.0f), aspectRatio, 0.1f, 100.0f);
+        
+        m_cameraPos = glm::vec3(0.0f, 0.0f, 5.0f);
+        m_cameraYaw = 0.0f;
+        m_cameraPitch = 0.0f;
+        m_cameraDistance = 5.0f;
+        updateViewMatrix();
+        
+        m_initialized = true;
+        recordContextInit(initStart);
+        std::cout << "Renderer por software inicializado con " << m_softwareRasterizer->getThreadCount() << " hilos" << std::endl;
+        return true;
     }
     
-    // Configurar GLFW para modo headless
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
-    
-    // Crear ventana oculta
-    m_window = glfwCreateWindow(width, height, "STL Renderer Headless", NULL, NULL);
-    if (!m_window) {
-        std::cerr << "Error al crear ventana GLFW headless" << std::endl;
-        glfwTerminate();
-        return false;
+    // Contexto sin ventana: no necesita servidor gráfico y arranca más rápido
+    if (m_headlessProvider != HeadlessProvider::Glfw || !m_allowWindowFallback) {
+        m_context = HeadlessContext::create(m_headlessProvider);
+        
+        if (m_context) {
+            if (!m_context->makeCurrent() || !m_context->loadGL()) {
+                std::cerr << "Error al activar el contexto " << headlessProviderName(m_context->getProvider()) << std::endl;
+                m_context.reset();
+                return false;
+            }
+        } else if (m_headlessProvider != HeadlessProvider::Auto || !m_allowWindowFallback) {
+            std::cerr << "Proveedor headless no disponible: " << headlessProviderName(m_headlessProvider) << std::endl;
+            return false;
+        } else {
+            std::cout << "Sin contexto EGL/OSMesa, usando ventana GLFW oculta" << std::endl;
+        }
     }
     
-    glfwMakeContextCurrent(m_window);
-    
-    // Inicializar GLAD
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
-        std::cerr << "Error al inicializar GLAD en modo headless" << std::endl;
-        return false;
+    if (!m_context) {
+        // Ventana oculta: solo aporta el contexto; la salida va a framebuffers offscreen.
+        // Sin fábrica de ventanas (biblioteca sin interfaz) no hay este último recurso
+        m_context = HeadlessContext::createWindow(std::min(width, 1024), std::min(height, 1024), false);
+        if (!m_context) {
+            std::cerr << "Error al crear ventana GLFW headless" << std::endl;
+            return false;
+        }
+        m_window = static_cast<GLFWwindow*>(m_context->getNativeWindow());
+        
+        // Inicializar GLAD
+        if (!m_context->loadGL()) {
+            std::cerr << "Error al inicializar GLAD en modo headless" << std::endl;
+            return false;
+        }
     }
     
     // Configurar viewport
@@ -224,7 +278,6 @@ bool Renderer::initializeHeadless(int width, int height) {
     // Crear shaders y buffers
     createShaders();
     setupBuffers();
-    setupFramebuffer();
     createDefaultCube();
     
     // Configurar matriz de proyección (Ajustar FOV y distancias)
@@ -242,10 +295,48 @@ bool Renderer::initializeHeadless(int width, int height) {
     // Configuración OpenGL
     glEnable(GL_DEPTH_TEST);
     
-    std::cout << "Renderer en modo headless inicializado correctamente" << std::endl;
+    m_initialized = true;
+    recordContextInit(initStart);
+    std::cout << "Renderer en modo headless inicializado correctamente en " << m_contextInitMs << " ms" << std::endl;
     return true;
 }
 
+void Renderer::recordContextInit(std::chrono::steady_clock::time_point start) {
+    m_contextInitCount++;
+    m_contextInitMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void Renderer::resetScene() {
+    // Liberar la malla anterior; el VBO se conserva y setModel lo reescribe
+    m_model = Model();
+    m_hasModel = false;
+    m_vertexCount = 0;
+    m_progressiveCapacity = 0;
+    m_uploadedTriangles = 0;
+    m_modelRevision++;
+    
+    float aspectRatio = (float)m_width / (float)m_height;
+    m_projectionMatrix = glm::perspective(glm::radians(45.0f), aspectRatio, 0.1f, 100.0f);
+    
+    m_cameraTarget = glm::vec3(0.0f, 0.0f, 0.0f);
+    m_cameraPos = glm::vec3(0.0f, 0.0f, 5.0f);
+    m_cameraYaw = 0.0f;
+    m_cameraPitch = 0.0f;
+    m_cameraDistance = 5.0f;
+    updateViewMatrix();
+}
+
+void Renderer::setOutputSize(int width, int height) {
+    if (width <= 0 || height <= 0) {
+        std::cerr << "Error: Tamaño de salida inválido: " << width << "x" << height << std::endl;
+        return;
+    }
+    
+    // No se crea nada aquí: renderToFile pide al pool un framebuffer de este tamaño
+    m_width = width;
+    m_height = height;
+}
+
 void Renderer::setBackgroundColor(const Color& color) {
     m_backgroundColor = color;
 }
@@ -269,8 +360,6 @@ void Renderer::setCameraOrbit(float yaw, float pitch, float distance) {
     m_cameraPitch = pitch;
     m_cameraDistance = distance;
     
-    std::cout << "setCameraOrbit: yaw=" << yaw << ", pitch=" << pitch << ", distance=" << distance << std::endl;
-    
     // Usar los ángulos directamente (ya están en radianes)
     float yawRad = yaw;
     float pitchRad = pitch;
@@ -281,7 +370,6 @@ void Renderer::setCameraOrbit(float yaw, float pitch, float distance) {
     float z = m_cameraTarget.z + distance * cos(pitchRad) * sin(yawRad);
     
     m_cameraPos = glm::vec3(x, y, z);
-    std::cout << "Posición calculada de la cámara: (" << m_cameraPos.x << ", " << m_cameraPos.y << ", " << m_cameraPos.z << ")" << std::endl;
     
     updateViewMatrix();
 }
@@ -318,53 +406,35 @@ void Renderer::centerCamera() {
 void Renderer::render() {
     if (!m_initialized) return;
     
-    // Verificar si estamos dentro de un contexto ImGui
-    ImGuiContext* context = ImGui::GetCurrentContext();
-    if (context && context->WithinFrameScope) {
-        // Esta función es llamada desde el interior de ImGui::Begin/End
-        // Obtener el tamaño y posición de la ventana de ImGui actual
-        ImVec2 windowPos = ImGui::GetWindowPos();
-        ImVec2 windowSize = ImGui::GetWindowSize();
-        
-        // Ajustar el viewport
-        int viewport[4] = {
-            (int)windowPos.x, 
-            (int)(m_height - (windowPos.y + windowSize.y)),
-            (int)windowSize.x, 
-            (int)windowSize.y
-        };
-        
-        // Proyección
-        float aspectRatio = (float)viewport[2] / (float)viewport[3];
-        m_projectionMatrix = glm::perspective(glm::radians(45.0f), aspectRatio, 0.1f, 100.0f);
-        
-        // Ajustar viewport a sección de ImGui
-        glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
-        
-        // Usar scissor test para limpiar solo el área de nuestra ventana
-        glEnable(GL_SCISSOR_TEST);
-        glScissor(viewport[0], viewport[1], viewport[2], viewport[3]);
-        
-        // Limpiar el contenido anterior
-        glClearColor(m_backgroundColor.r, m_backgroundColor.g, m_backgroundColor.b, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        
-        // Renderizar modelo
-        renderModel();
-        
-        // Desactivar scissor test
-        glDisable(GL_SCISSOR_TEST);
-    } else {
-        // Renderizado normal fuera de ImGui
-        glViewport(0, 0, m_width, m_height);
-        
-        // Establecer color de fondo
-        glClearColor(m_backgroundColor.r, m_backgroundColor.g, m_backgroundColor.b, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        
-        // Renderizar modelo
-        renderModel();
-    }
+    glViewport(0, 0, m_width, m_height);
+    
+    // Establecer color de fondo
+    glClearColor(m_backgroundColor.r, m_backgroundColor.g, m_backgroundColor.b, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    
+    // Renderizar modelo
+    renderModel();
+}
+
+void Renderer::renderViewport(int x, int y, int width, int height) {
+    if (!m_initialized || width <= 0 || height <= 0) return;
+    
+    // Proyección con la proporción del rectángulo
+    float aspectRatio = (float)width / (float)height;
+    m_projectionMatrix = glm::perspective(glm::radians(45.0f), aspectRatio, 0.1f, 100.0f);
+    
+    glViewport(x, y, width, height);
+    
+    // Usar scissor test para limpiar solo el área del rectángulo
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(x, y, width, height);
+    
+    glClearColor(m_backgroundColor.r, m_backgroundColor.g, m_backgroundColor.b, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    
+    renderModel();
+    
+    glDisable(GL_SCISSOR_TEST);
 }
 
 void Renderer::renderModel() {
@@ -386,9 +456,9 @@ void Renderer::renderModel() {
     m_shader->setMat4("model", model);
     
     // Renderizar el modelo si hay uno cargado
-    if (m_hasModel && m_vao != 0) {
+    if (m_hasModel && m_vao != 0 && m_vertexCount > 0) {
         glBindVertexArray(m_vao);
-        glDrawArrays(GL_TRIANGLES, 0, m_model.triangles.size() * 3);
+        glDrawArrays(GL_TRIANGLES, 0, (int)m_vertexCount);
         glBindVertexArray(0);
     } else {
         // Renderizar un cubo por defecto usando el VAO del cubo
@@ -400,18 +470,233 @@ void Renderer::renderModel() {
     }
 }
 
+unsigned int Renderer::renderPreview(int width, int height) {
+    if (!m_initialized || m_backend != RenderBackend::OpenGL || width <= 0 || height <= 0) {
+        return 0;
+    }
+    
+    PreviewState state;
+    state.cameraPos = m_cameraPos;
+    state.cameraTarget = m_cameraTarget;
+    state.modelColor = m_modelColor;
+    state.backgroundColor = m_backgroundColor;
+    state.modelRevision = m_modelRevision;
+    state.width = width;
+    state.height = height;
+    
+    // Nada ha cambiado: la textura del frame anterior sigue siendo válida
+    if (m_previewTexture != 0 && state == m_previewState) {
+        return m_previewTexture;
+    }
+    
+    if (!resizePreviewTarget(width, height)) {
+        return 0;
+    }
+    
+    // Guardar el framebuffer y el viewport de la ventana para restaurarlos
+    int previousFbo = 0;
+    int previousViewport[4];
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFbo);
+    glGetIntegerv(GL_VIEWPORT, previousViewport);
+    
+    glBindFramebuffer(GL_FRAMEBUFFER, m_previewFbo);
+    glViewport(0, 0, width, height);
+    
+    glClearColor(m_backgroundColor.r, m_backgroundColor.g, m_backgroundColor.b, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    
+    // Proyección con el aspect ratio del panel para evitar la distorsión
+    float aspectRatio = (float)width / (float)height;
+    m_projectionMatrix = glm::perspective(glm::radians(45.0f), aspectRatio, 0.1f, 100.0f);
+    
+    glEnable(GL_DEPTH_TEST);
+    renderModel();
+    
+    glBindFramebuffer(GL_FRAMEBUFFER, previousFbo);
+    glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+    
+    m_previewState = state;
+    return m_previewTexture;
+}
+
+bool Renderer::resizePreviewTarget(int width, int height) {
+    if (m_previewFbo != 0 && m_previewState.width == width && m_previewState.height == height) {
+        return true;
+    }
+    
+    destroyPreviewTarget();
+    
+    // Color como textura para mostrarlo con ImGui::Image; profundidad como renderbuffer
+    glGenFramebuffers(1, &m_previewFbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_previewFbo);
+    
+    glGenTextures(1, &m_previewTexture);
+    glBindTexture(GL_TEXTURE_2D, m_previewTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_previewTexture, 0);
+    
+    glGenRenderbuffers(1, &m_previewDepth);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_previewDepth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_previewDepth);
+    
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    
+    if (!complete) {
+        std::cerr << "Error: Framebuffer de vista previa incompleto (" << width << "x" << height << ")" << std::endl;
+        destroyPreviewTarget();
+        return false;
+    }
+    
+    return true;
+}
+
+void Renderer::destroyPreviewTarget() {
+    if (m_previewFbo != 0) {
+        glDeleteFramebuffers(1, &m_previewFbo);
+        m_previewFbo = 0;
+    }
+    
+    if (m_previewTexture != 0) {
+        glDeleteTextures(1, &m_previewTexture);
+        m_previewTexture = 0;
+    }
+    
+    if (m_previewDepth != 0) {
+        glDeleteRenderbuffers(1, &m_previewDepth);
+        m_previewDepth = 0;
+    }
+    
+    m_previewState = PreviewState();
+}
+
 bool Renderer::renderToFile(const std::string& filename, bool transparentBackground) {
-    // Verificar que el framebuffer esté configurado
-    if (m_fbo == 0) {
-        setupFramebuffer();
-        if (m_fbo == 0) {
-            std::cerr << "Error: No se pudo crear el framebuffer" << std::endl;
+    if (m_backend == RenderBackend::Software) {
+        return renderToFileSoftware(filename, transparentBackground);
+    }
+    
+    // Pósters mayores que el framebuffer máximo (o demasiado grandes para tenerlos en memoria)
+    if (needsTiledOutput()) {
+        return renderToFileTiled(filename, transparentBackground);
+    }
+    
+    if (!renderOutputFrame(transparentBackground)) {
+        return false;
+    }
+    
+    // Guardar a archivo
+    bool success = saveImage(filename, transparentBackground);
+    
+    // Restaurar framebuffer por defecto
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    
+    return success;
+}
+
+bool Renderer::renderToBuffer(std::vector<unsigned char>& buffer, int& numChannels, bool transparentBackground) {
+    numChannels = transparentBackground ? 4 : 3;
+    
+    if (m_backend == RenderBackend::Software) {
+        if (!m_softwareRasterizer) {
+            m_softwareRasterizer = std::make_unique<SoftwareRasterizer>();
+        }
+        if (!m_hasModel || m_model.triangles.empty()) {
+            std::cerr << "ERROR: El renderer por software necesita un modelo cargado" << std::endl;
+            return false;
+        }
+        return m_softwareRasterizer->render(m_model, makeRasterParams(transparentBackground), m_width, m_height, numChannels, buffer);
+    }
+    
+    // Los pósters se escriben por bandas directamente al PNG: usar renderToFile
+    if (needsTiledOutput()) {
+        std::cerr << "Error: La salida de " << m_width << "x" << m_height << " no cabe en memoria, usar renderToFile" << std::endl;
+        return false;
+    }
+    
+    if (!renderOutputFrame(transparentBackground)) {
+        return false;
+    }
+    
+    bool success = readOutputPixels(buffer, transparentBackground);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    return success;
+}
+
+bool Renderer::renderImage(Model&& model, const RenderJobSettings& settings, RenderedImage& image, ImageEncoding encoding) {
+    applyJobSettings(settings);
+    
+    // Subida completa en una llamada y la misma cámara que renderSingleFile
+    beginModelUpload(std::move(model));
+    uploadModelChunk(std::numeric_limits<size_t>::max());
+    centerCamera();
+    setCameraOrbit(settings.cameraYaw, settings.cameraPitch, settings.cameraDistance);
+    
+    image.width = m_width;
+    image.height = m_height;
+    image.encoding = encoding;
+    if (!renderToBuffer(image.data, image.channels, settings.transparentBackground)) {
+        image.data.clear();
+        return false;
+    }
+    
+    if (encoding == ImageEncoding::Png) {
+        std::vector<unsigned char> png;
+        if (!encodePng(image.data.data(), image.width, image.height, image.channels, png)) {
+            image.data.clear();
             return false;
         }
+        image.data.swap(png);
+    }
+    return true;
+}
+
+void Renderer::applyJobSettings(const RenderJobSettings& settings) {
+    // Cambiar de tamaño no crea nada: el pool guarda un framebuffer por tamaño
+    if (settings.width != m_width || settings.height != m_height) {
+        setOutputSize(settings.width, settings.height);
+    }
+    setOutputSamples(settings.samples);
+    setBackgroundColor(settings.backgroundColor);
+    setModelColor(settings.modelColor);
+}
+
+bool Renderer::encodePng(const unsigned char* pixels, int width, int height, int numChannels, std::vector<unsigned char>& png) {
+    png.clear();
+    // Las miniaturas suelen comprimir a menos de una cuarta parte
+    png.reserve(static_cast<size_t>(width) * height * numChannels / 4);
+    if (stbi_write_png_to_func(appendPngBytes, &png, width, height, numChannels, pixels, width * numChannels) == 0) {
+        std::cerr << "ERROR: No se pudo codificar el PNG en memoria" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void Renderer::replaceOutputFile(const std::string& filename) {
+    std::error_code ec;
+    std::filesystem::remove(filename, ec);
+}
+
+bool Renderer::writePng(const std::string& filename, const unsigned char* pixels, int width, int height, int numChannels) {
+    replaceOutputFile(filename);
+    return stbi_write_png(filename.c_str(), width, height, numChannels, pixels, width * numChannels) != 0;
+}
+
+bool Renderer::renderOutputFrame(bool transparentBackground) {
+    // Framebuffer del tamaño actual (reutilizado si ya se pidió antes)
+    if (!m_framebufferPool.acquire(m_width, m_height, m_outputSamples, m_outputFramebuffer)) {
+        std::cerr << "Error: No se pudo crear el framebuffer" << std::endl;
+        return false;
     }
     
     // Realizar renderizado al framebuffer
-    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_outputFramebuffer.fbo);
     
     // Verificar estado del framebuffer
     if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
@@ -436,6 +721,182 @@ bool Renderer::renderToFile(const std::string& filename, bool transparentBackgro
     // Limpiar buffers
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     
+    // Dibujar el modelo (o el cubo por defecto) con la iluminación de salida
+    if (!drawOutputScene()) {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        return false;
+    }
+    
+    // Verificar errores de OpenGL
+    int err = glGetError();
+    if (err != 0) {
+        std::cerr << "ERROR OpenGL: " << err << std::endl;
+    }
+    
+    // Resolver el MSAA antes de leer
+    m_framebufferPool.resolve(m_outputFramebuffer);
+    
+    // Asegurarse de que todo se haya dibujado
+    glFlush();
+    glFinish();
+    
+    return true;
+}
+
+bool Renderer::needsTiledOutput() const {
+    if (m_backend == RenderBackend::Software) {
+        return false;
+    }
+    
+    int maxSize = getMaxFramebufferSize();
+    if (maxSize > 0 && (m_width > maxSize || m_height > maxSize)) {
+        return true;
+    }
+    
+    return (long long)m_width * m_height > kTiledOutputPixels;
+}
+
+bool Renderer::renderToFileTiled(const std::string& filename, bool transparentBackground) {
+    int maxSize = getMaxFramebufferSize();
+    int tileSize = maxSize > 0 ? std::min(maxSize, kPosterTileSize) : kPosterTileSize;
+    int tileWidth = std::min(tileSize, m_width);
+    int tileHeight = std::min(tileSize, m_height);
+    int columns = (m_width + tileWidth - 1) / tileWidth;
+    int rows = (m_height + tileHeight - 1) / tileHeight;
+    
+    std::cout << "Renderizando póster " << m_width << "x" << m_height << " en " << columns << "x" << rows
+              << " tiles de " << tileWidth << "x" << tileHeight << std::endl;
+    
+    // Un único framebuffer del pool para todos los tiles
+    PooledFramebuffer tile;
+    if (!m_framebufferPool.acquire(tileWidth, tileHeight, m_outputSamples, tile)) {
+        std::cerr << "Error: No se pudo crear el framebuffer de tiles" << std::endl;
+        return false;
+    }
+    
+    unsigned int format = transparentBackground ? GL_RGBA : GL_RGB;
+    int numChannels = transparentBackground ? 4 : 3;
+    
+    // Las filas se comprimen según se completa cada banda de tiles
+    PngStreamWriter writer;
+    replaceOutputFile(filename);
+    if (!writer.open(filename, m_width, m_height, numChannels)) {
+        return false;
+    }
+    
+    // Frustum equivalente a glm::perspective(45°); cada tile usa su porción
+    const float nearPlane = 0.1f;
+    const float farPlane = 100.0f;
+    float top = nearPlane * std::tan(glm::radians(45.0f) * 0.5f);
+    float right = top * (float)m_width / (float)m_height;
+    glm::mat4 savedProjection = m_projectionMatrix;
+    
+    size_t bandStride = (size_t)m_width * numChannels;
+    std::vector<unsigned char> band(bandStride * tileHeight);
+    std::vector<unsigned char> tilePixels((size_t)tileWidth * tileHeight * numChannels);
+    
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    
+    bool success = true;
+    for (int row = 0; row < rows && success; ++row) {
+        // Banda de arriba a abajo, como la escribe el PNG
+        int y0 = row * tileHeight;
+        int bandHeight = std::min(tileHeight, m_height - y0);
+        
+        for (int col = 0; col < columns; ++col) {
+            int x0 = col * tileWidth;
+            int width = std::min(tileWidth, m_width - x0);
+            
+            float tileLeft = -right + 2.0f * right * x0 / m_width;
+            float tileRight = -right + 2.0f * right * (x0 + width) / m_width;
+            float tileTop = top - 2.0f * top * y0 / m_height;
+            float tileBottom = top - 2.0f * top * (y0 + bandHeight) / m_height;
+            m_projectionMatrix = glm::frustum(tileLeft, tileRight, tileBottom, tileTop, nearPlane, farPlane);
+            
+            glBindFramebuffer(GL_FRAMEBUFFER, tile.fbo);
+            glViewport(0, 0, width, bandHeight);
+            
+            if (transparentBackground) {
+                glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+            } else {
+                glClearColor(m_backgroundColor.r, m_backgroundColor.g, m_backgroundColor.b, 1.0f);
+            }
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            
+            if (!drawOutputScene()) {
+                success = false;
+                break;
+            }
+            
+            m_framebufferPool.resolve(tile);
+            glBindFramebuffer(GL_FRAMEBUFFER, tile.readFbo());
+            glReadPixels(0, 0, width, bandHeight, format, GL_UNSIGNED_BYTE, tilePixels.data());
+            
+            int err = glGetError();
+            if (err != 0) {
+                std::cerr << "ERROR en glReadPixels del tile (" << col << ", " << row << "): " << err << std::endl;
+                success = false;
+                break;
+            }
+            
+            // Colocar el tile en la banda volteando sus filas
+            size_t tileStride = (size_t)width * numChannels;
+            for (int y = 0; y < bandHeight; ++y) {
+                std::memcpy(&band[y * bandStride + (size_t)x0 * numChannels],
+                            &tilePixels[(bandHeight - 1 - y) * tileStride], tileStride);
+            }
+        }
+        
+        if (success) {
+            success = writer.writeRows(band.data(), bandHeight);
+        }
+    }
+    
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    m_projectionMatrix = savedProjection;
+    
+    bool closed = writer.close();
+    if (success && closed) {
+        std::cout << "Póster guardado en: " << filename << std::endl;
+    }
+    return success && closed;
+}
+
+bool Renderer::renderToFileSoftware(const std::string& filename, bool transparentBackground) {
+    if (!m_softwareRasterizer) {
+        m_softwareRasterizer = std::make_unique<SoftwareRasterizer>();
+    }
+    
+    if (!m_hasModel || m_model.triangles.empty()) {
+        std::cerr << "ERROR: El renderer por software necesita un modelo cargado" << std::endl;
+        return false;
+    }
+    
+    int numChannels = transparentBackground ? 4 : 3;
+    std::vector<unsigned char> buffer;
+    
+    if (!m_softwareRasterizer->render(m_model, makeRasterParams(transparentBackground), m_width, m_height, numChannels, buffer)) {
+        return false;
+    }
+    
+    return writeImage(filename, buffer, numChannels);
+}
+
+RasterParams Renderer::makeRasterParams(bool transparentBackground) const {
+    // Mismos parámetros que la ruta OpenGL de renderToFile
+    RasterParams params;
+    float aspectRatio = (float)m_width / (float)m_height;
+    params.projection = glm::perspective(glm::radians(45.0f), aspectRatio, 0.1f, 100.0f);
+    params.view = m_viewMatrix;
+    params.cameraPos = m_cameraPos;
+    params.lightPos = m_cameraPos + glm::vec3(0.0f, 1.0f, 0.0f);
+    params.objectColor = m_modelColor;
+    params.backgroundColor = m_backgroundColor;
+    params.transparentBackground = transparentBackground;
+    return params;
+}
+
+bool Renderer::drawOutputScene() {
     // Asegurarse de que el depth test esté habilitado
     glEnable(GL_DEPTH_TEST);
     glDepthFunc(GL_LESS);
@@ -461,9 +922,9 @@ bool Renderer::renderToFile(const std::string& filename, bool transparentBackgro
     m_shader->setVec3("viewPos", m_cameraPos.x, m_cameraPos.y, m_cameraPos.z);
     
     // Renderizar el modelo
-    if (m_hasModel && !m_model.triangles.empty() && m_vao != 0) {
+    if (m_hasModel && m_vertexCount > 0 && m_vao != 0) {
         glBindVertexArray(m_vao);
-        glDrawArrays(GL_TRIANGLES, 0, m_model.triangles.size() * 3);
+        glDrawArrays(GL_TRIANGLES, 0, (int)m_vertexCount);
         glBindVertexArray(0);
     } else {
         // Renderizar el cubo por defecto si no hay modelo
@@ -473,33 +934,20 @@ bool Renderer::renderToFile(const std::string& filename, bool transparentBackgro
             glBindVertexArray(0);
         } else {
             std::cerr << "ERROR: No hay cubo por defecto disponible" << std::endl;
-            glBindFramebuffer(GL_FRAMEBUFFER, 0);
             return false;
         }
     }
     
-    // Verificar errores de OpenGL
-    int err = glGetError();
-    if (err != 0) {
-        std::cerr << "ERROR OpenGL: " << err << std::endl;
-    }
-    
-    // Asegurarse de que todo se haya dibujado
-    glFlush();
-    glFinish();
-    
-    // Guardar a archivo
-    bool success = saveImage(filename, transparentBackground);
-    
-    // Restaurar framebuffer por defecto
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    
-    return success;
+    return true;
 }
 
 void Renderer::setModel(const Model& model) {
     m_model = model;
     m_hasModel = true;
+    m_modelRevision++;
+    m_progressiveCapacity = 0;
+    m_vertexCount = 0;
+    m_uploadedTriangles = model.triangles.size();
     
     // Verificar que el modelo tenga triángulos
     if (model.triangles.empty()) {
@@ -508,6 +956,11 @@ void Renderer::setModel(const Model& model) {
         return;
     }
     
+    // El rasterizador por CPU lee m_model directamente, no hay VBO que actualizar
+    if (m_backend == RenderBackend::Software) {
+        return;
+    }
+    
     // Actualizar VBO con los datos del modelo
     std::vector<float> vertexData;
     vertexData.reserve(model.triangles.size() * 3 * 6); // 3 vértices por triángulo, 6 floats por vértice (3 pos + 3 normal)
@@ -534,6 +987,7 @@ void Renderer::setModel(const Model& model) {
     
     // Cargar datos
     glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(float), vertexData.data(), GL_STATIC_DRAW);
+    m_vertexCount = model.triangles.size() * 3;
     
     // Verificar si hubo error
     int err = glGetError();
@@ -546,6 +1000,129 @@ void Renderer::setModel(const Model& model) {
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
+bool Renderer::beginProgressiveModel(size_t capacityTriangles) {
+    // El rasterizador por CPU no tiene vista previa; sin VBO no hay dónde escribir
+    if (m_backend != RenderBackend::OpenGL || m_vbo == 0 || capacityTriangles == 0) {
+        return false;
+    }
+    
+    m_model = Model();
+    m_hasModel = true;
+    m_vertexCount = 0;
+    m_progressiveCapacity = capacityTriangles * 3;
+    m_uploadedTriangles = 0;
+    m_modelRevision++;
+    
+    // Reservar el VBO completo una vez; los bloques se escriben con glBufferSubData
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    glBufferData(GL_ARRAY_BUFFER, m_progressiveCapacity * 6 * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    
+    int err = glGetError();
+    if (err != 0) {
+        std::cerr << "ERROR de OpenGL al reservar el VBO progresivo: " << err << std::endl;
+        m_progressiveCapacity = 0;
+        m_hasModel = false;
+        return false;
+    }
+    
+    return true;
+}
+
+void Renderer::appendProgressiveTriangles(const Triangle* triangles, size_t count) {
+    if (m_progressiveCapacity == 0 || count == 0) {
+        return;
+    }
+    
+    // Los triángulos de la vista previa ya vienen normalizados
+    writeVertices(triangles, count, glm::vec3(0.0f), 1.0f);
+}
+
+void Renderer::beginModelUpload(Model&& model) {
+    m_model = std::move(model);
+    m_hasModel = !m_model.triangles.empty();
+    m_uploadedTriangles = 0;
+    m_vertexCount = 0;
+    m_modelRevision++;
+    
+    // Sin VBO (rasterizador por CPU) el modelo ya está listo
+    if (m_backend != RenderBackend::OpenGL || m_vbo == 0 || !m_hasModel) {
+        m_progressiveCapacity = 0;
+        m_uploadedTriangles = m_model.triangles.size();
+        return;
+    }
+    
+    m_progressiveCapacity = m_model.triangles.size() * 3;
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    glBufferData(GL_ARRAY_BUFFER, m_progressiveCapacity * 6 * sizeof(float), nullptr, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+bool Renderer::uploadModelChunk(size_t maxTriangles) {
+    if (!isUploadingModel()) {
+        return true;
+    }
+    
+    size_t count = std::min(maxTriangles, m_model.triangles.size() - m_uploadedTriangles);
+    writeVertices(m_model.triangles.data() + m_uploadedTriangles, count, m_model.center, m_model.scale);
+    m_uploadedTriangles += count;
+    
+    if (!isUploadingModel()) {
+        m_progressiveCapacity = 0;
+        return true;
+    }
+    return false;
+}
+
+void Renderer::releaseModelData() {
+    std::vector<Triangle>().swap(m_model.triangles);
+    m_uploadedTriangles = 0;
+    m_vertexCount = 0;
+    m_hasModel = false;
+    
+    // Con llvmpipe/OSMesa el VBO también vive en RAM
+    if (m_backend == RenderBackend::OpenGL && m_vbo != 0) {
+        glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+}
+
+float Renderer::getUploadProgress() const {
+    if (m_model.triangles.empty()) {
+        return 1.0f;
+    }
+    return (float)m_uploadedTriangles / (float)m_model.triangles.size();
+}
+
+void Renderer::writeVertices(const Triangle* triangles, size_t count, const glm::vec3& center, float scale) {
+    // Si la capacidad reservada se quedó corta, se descarta lo que no cabe
+    size_t vertexCount = std::min(count * 3, m_progressiveCapacity - m_vertexCount);
+    if (vertexCount == 0) {
+        return;
+    }
+    
+    std::vector<float> vertexData;
+    vertexData.reserve(vertexCount * 6);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        const Vertex& vertex = triangles[v / 3].vertices[v % 3];
+        glm::vec3 position = (vertex.position - center) * scale;
+        vertexData.push_back(position.x);
+        vertexData.push_back(position.y);
+        vertexData.push_back(position.z);
+        vertexData.push_back(vertex.normal.x);
+        vertexData.push_back(vertex.normal.y);
+        vertexData.push_back(vertex.normal.z);
+    }
+    
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    glBufferSubData(GL_ARRAY_BUFFER, m_vertexCount * 6 * sizeof(float), vertexData.size() * sizeof(float), vertexData.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    
+    m_vertexCount += vertexCount;
+    m_modelRevision++;
+}
+
 void Renderer::createShaders() {
     // Utilizar la nueva clase Shader para crear los shaders
     m_shader = std::make_unique<Shader>(vertexShaderSource, fragmentShaderSource);
@@ -575,33 +1152,6 @@ void Renderer::setupBuffers() {
     glBindVertexArray(0);
 }
 
-void Renderer::setupFramebuffer() {
-    // Crear framebuffer
-    glGenFramebuffers(1, &m_fbo);
-    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
-    
-    // Crear textura de color
-    glGenTextures(1, &m_colorAttachment);
-    glBindTexture(GL_TEXTURE_2D, m_colorAttachment);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_width, m_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_colorAttachment, 0);
-    
-    // Crear renderbuffer para profundidad
-    glGenRenderbuffers(1, &m_depthAttachment);
-    glBindRenderbuffer(GL_RENDERBUFFER, m_depthAttachment);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, m_width, m_height);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depthAttachment);
-    
-    // Verificar que el framebuffer esté completo
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-        std::cerr << "Error: Framebuffer incompleto" << std::endl;
-    }
-    
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-}
-
 void Renderer::destroyGLResources() {
     // Liberar recursos de OpenGL
     if (m_vao != 0) {
@@ -624,21 +1174,11 @@ void Renderer::destroyGLResources() {
         m_defaultCubeVBO = 0;
     }
     
-    // Liberar recursos del framebuffer
-    if (m_fbo != 0) {
-        glDeleteFramebuffers(1, &m_fbo);
-        m_fbo = 0;
-    }
-    
-    if (m_colorAttachment != 0) {
-        glDeleteTextures(1, &m_colorAttachment);
-        m_colorAttachment = 0;
-    }
-    
-    if (m_depthAttachment != 0) {
-        glDeleteRenderbuffers(1, &m_depthAttachment);
-        m_depthAttachment = 0;
-    }
+    // Liberar los framebuffers offscreen (salida y atlas)
+    m_framebufferPool.clear();
+    m_outputFramebuffer = PooledFramebuffer();
+    m_atlasFramebuffer = PooledFramebuffer();
+    destroyPreviewTarget();
     
     // El shader se liberará automáticamente por el unique_ptr
     m_shader.reset();
@@ -647,20 +1187,32 @@ void Renderer::destroyGLResources() {
 void Renderer::updateViewMatrix() {
     // Crear matriz de vista
     m_viewMatrix = glm::lookAt(m_cameraPos, m_cameraTarget, glm::vec3(0.0f, 1.0f, 0.0f));
-    
-    std::cout << "Matriz de vista actualizada. Posición: (" << m_cameraPos.x << ", " << m_cameraPos.y << ", " << m_cameraPos.z << "), Target: (" << m_cameraTarget.x << ", " << m_cameraTarget.y << ", " << m_cameraTarget.z << ")" << std::endl;
 }
 
 bool Renderer::saveImage(const std::string& filename, bool transparentBackground) {
-    // Leer píxeles del framebuffer
-    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+    std::vector<unsigned char> buffer;
+    if (!readOutputPixels(buffer, transparentBackground)) {
+        return false;
+    }
+    
+    return writeImage(filename, buffer, transparentBackground ? 4 : 3);
+}
+
+bool Renderer::readOutputPixels(std::vector<unsigned char>& buffer, bool transparentBackground) {
+    if (m_outputFramebuffer.fbo == 0) {
+        std::cerr << "ERROR: No hay framebuffer de salida del que leer" << std::endl;
+        return false;
+    }
+    
+    // Leer píxeles del framebuffer (el resuelto si hay MSAA)
+    glBindFramebuffer(GL_FRAMEBUFFER, m_outputFramebuffer.readFbo());
     
     // Formato: RGBA si es transparente, RGB si no
     unsigned int format = transparentBackground ? GL_RGBA : GL_RGB;
     int numChannels = transparentBackground ? 4 : 3;
     
     // Crear buffer para los datos de la imagen
-    std::vector<unsigned char> buffer(m_width * m_height * numChannels);
+    buffer.assign((size_t)m_width * m_height * numChannels, 0);
     
     if (buffer.size() == 0 || buffer.data() == nullptr) {
         std::cerr << "ERROR: No se pudo asignar memoria para el buffer de imagen (" 
@@ -689,6 +1241,13 @@ bool Renderer::saveImage(const std::string& filename, bool transparentBackground
         }
     }
     
+    // Volver al framebuffer por defecto
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    
+    return true;
+}
+
+bool Renderer::writeImage(const std::string& filename, const std::vector<unsigned char>& buffer, int numChannels) {
     // DIAGNÓSTICO: Detectar el contenido real de la imagen de manera más detallada
     bool allBlack = true;
     bool allWhite = true;
@@ -735,19 +1294,160 @@ bool Renderer::saveImage(const std::string& filename, bool transparentBackground
     
     // Guardar imagen a archivo
     std::cout << "Guardando imagen usando stbi_write_png..." << std::endl;
-    int result = stbi_write_png(filename.c_str(), m_width, m_height, numChannels,
-                               buffer.data(), m_width * numChannels);
-    
-    // Volver al framebuffer por defecto
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    bool result = writePng(filename, buffer.data(), m_width, m_height, numChannels);
     
-    if (result == 0) {
+    if (!result) {
         std::cerr << "ERROR: stbi_write_png falló al guardar la imagen" << std::endl;
     } else {
         std::cout << "stbi_write_png completado correctamente, imagen guardada en: " << filename << std::endl;
     }
     
-    return result != 0;
+    return result;
+}
+
+int Renderer::getMaxFramebufferSize() const {
+    // Sin contexto OpenGL no hay framebuffers (el atlas queda desactivado)
+    if (m_backend == RenderBackend::Software) {
+        return 0;
+    }
+    
+    // El límite real es el menor entre renderbuffer, textura y viewport
+    int maxRenderbuffer = 0;
+    int maxTexture = 0;
+    int maxViewport[2] = {0, 0};
+    glGetIntegerv(GL_MAX_RENDERBUFFER_SIZE, &maxRenderbuffer);
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTexture);
+    glGetIntegerv(GL_MAX_VIEWPORT_DIMS, maxViewport);
+    
+    int maxSize = maxRenderbuffer;
+    if (maxTexture > 0) maxSize = std::min(maxSize, maxTexture);
+    if (maxViewport[0] > 0) maxSize = std::min(maxSize, std::min(maxViewport[0], maxViewport[1]));
+    return maxSize;
+}
+
+bool Renderer::beginAtlas(int tileWidth, int tileHeight, int columns, int rows, bool transparentBackground) {
+    if (m_backend == RenderBackend::Software) {
+        std::cerr << "Error: El atlas requiere el backend OpenGL" << std::endl;
+        return false;
+    }
+    
+    if (tileWidth <= 0 || tileHeight <= 0 || columns <= 0 || rows <= 0) {
+        std::cerr << "Error: Parámetros de atlas inválidos" << std::endl;
+        return false;
+    }
+    
+    // El atlas se reutiliza mientras el pool conserve ese tamaño; mismo MSAA que un render suelto
+    if (!m_framebufferPool.acquire(tileWidth * columns, tileHeight * rows, m_outputSamples, m_atlasFramebuffer)) {
+        std::cerr << "Error: Framebuffer del atlas incompleto (" << tileWidth * columns << "x" << tileHeight * rows << ")" << std::endl;
+        m_atlasFramebuffer = PooledFramebuffer();
+        return false;
+    }
+    
+    m_atlasWidth = m_atlasFramebuffer.width;
+    m_atlasHeight = m_atlasFramebuffer.height;
+    
+    m_atlasTileWidth = tileWidth;
+    m_atlasTileHeight = tileHeight;
+    m_atlasColumns = columns;
+    m_atlasRows = rows;
+    m_atlasTransparent = transparentBackground;
+    
+    // Un único clear para todo el atlas en lugar de uno por miniatura
+    glBindFramebuffer(GL_FRAMEBUFFER, m_atlasFramebuffer.fbo);
+    glViewport(0, 0, m_atlasWidth, m_atlasHeight);
+    
+    if (transparentBackground) {
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    } else {
+        glClearColor(m_backgroundColor.r, m_backgroundColor.g, m_backgroundColor.b, 1.0f);
+    }
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    
+    // La proyección es la misma para todas las celdas
+    float aspectRatio = (float)tileWidth / (float)tileHeight;
+    m_projectionMatrix = glm::perspective(glm::radians(45.0f), aspectRatio, 0.1f, 100.0f);
+    
+    return true;
+}
+
+bool Renderer::renderAtlasTile(int index) {
+    if (m_atlasFramebuffer.fbo == 0 || index < 0 || index >= m_atlasColumns * m_atlasRows) {
+        std::cerr << "Error: Celda de atlas fuera de rango: " << index << std::endl;
+        return false;
+    }
+    
+    int x = (index % m_atlasColumns) * m_atlasTileWidth;
+    int y = (index / m_atlasColumns) * m_atlasTileHeight;
+    
+    glBindFramebuffer(GL_FRAMEBUFFER, m_atlasFramebuffer.fbo);
+    glViewport(x, y, m_atlasTileWidth, m_atlasTileHeight);
+    
+    // El modelo normalizado cabe en su celda, pero recortamos por si la cámara está muy cerca
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(x, y, m_atlasTileWidth, m_atlasTileHeight);
+    
+    bool success = drawOutputScene();
+    
+    glDisable(GL_SCISSOR_TEST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    
+    return success;
+}
+
+bool Renderer::readAtlasTiles(const std::vector<int>& indices, std::vector<std::vector<unsigned char>>& images) {
+    images.clear();
+    if (m_atlasFramebuffer.fbo == 0) {
+        std::cerr << "Error: No hay atlas activo" << std::endl;
+        return false;
+    }
+    
+    if (indices.empty()) {
+        return true;
+    }
+    
+    unsigned int format = m_atlasTransparent ? GL_RGBA : GL_RGB;
+    int numChannels = m_atlasTransparent ? 4 : 3;
+    
+    // Leer solo las filas de celdas realmente usadas
+    int lastIndex = 0;
+    for (int index : indices) {
+        lastIndex = std::max(lastIndex, index);
+    }
+    int readHeight = (lastIndex / m_atlasColumns + 1) * m_atlasTileHeight;
+    
+    // Una sola lectura para todas las miniaturas
+    std::vector<unsigned char> atlas((size_t)m_atlasWidth * readHeight * numChannels);
+    
+    m_framebufferPool.resolve(m_atlasFramebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_atlasFramebuffer.readFbo());
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, m_atlasWidth, readHeight, format, GL_UNSIGNED_BYTE, atlas.data());
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    
+    int err = glGetError();
+    if (err != 0) {
+        std::cerr << "ERROR en glReadPixels del atlas: " << err << std::endl;
+        return false;
+    }
+    
+    // Recortar cada celda en su propia imagen (volteando las filas como en saveImage)
+    size_t tileStride = (size_t)m_atlasTileWidth * numChannels;
+    size_t atlasStride = (size_t)m_atlasWidth * numChannels;
+    images.reserve(indices.size());
+    
+    for (int index : indices) {
+        int x = (index % m_atlasColumns) * m_atlasTileWidth;
+        int y = (index / m_atlasColumns) * m_atlasTileHeight;
+        
+        std::vector<unsigned char> tile(tileStride * m_atlasTileHeight);
+        for (int row = 0; row < m_atlasTileHeight; ++row) {
+            const unsigned char* src = atlas.data() + (size_t)(y + m_atlasTileHeight - 1 - row) * atlasStride + (size_t)x * numChannels;
+            std::memcpy(tile.data() + row * tileStride, src, tileStride);
+        }
+        images.push_back(std::move(tile));
+    }
+    
+    return true;
 }
 
 void Renderer::createDefaultCube() {
@@ -829,10 +1529,4 @@ void Renderer::createDefaultCube() {
 void Renderer::setProjectionMatrix(float fov, float aspectRatio, float nearPlane, float farPlane) {
     // Crear una nueva matriz de proyección con los parámetros dados
     m_projectionMatrix = glm::perspective(glm::radians(fov), aspectRatio, nearPlane, farPlane);
-    
-    // Debug
-    std::cout << "Matriz de proyección recalculada con FOV: " << fov 
-              << ", AspectRatio: " << aspectRatio 
-              << ", Near: " << nearPlane 
-              << ", Far: " << farPlane << std::endl;
 } 
\ No newline at end of file
@@ -1,7 +1,6 @@
 #pragma once
 
 #include <glad/glad.h>
-#include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -10,11 +9,14 @@
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <chrono>
 #include "model.h"
 #include "shader.h"
-#include "imgui.h"
-#include "imgui_impl_glfw.h"
-#include "imgui_impl_opengl3.h"
+#include "headless_context.h"
+#include "framebuffer_pool.h"
+
+// La ventana solo la conoce el ejecutable con interfaz (ver GlfwContext)
+struct GLFWwindow;
 
 // Estructura para representar el color (RGB)
 struct Color {
@@ -27,13 +29,51 @@ struct Color {
     operator glm::vec3() const { return glm::vec3(r, g, b); }
 };
 
+// Parámetros de un render de salida; en las colas, copia de la configuración al encolar
+struct RenderJobSettings {
+    int width = 1024;
+    int height = 1024;
+    Color modelColor;
+    Color backgroundColor;
+    bool transparentBackground = false;
+    float cameraYaw = 0.0f;
+    float cameraPitch = 0.0f;
+    float cameraDistance = 5.0f;    // Como AppConfig: con 0 la cámara quedaría sobre el modelo
+    int samples = 1;
+};
+
+// Formato de la imagen que devuelve renderImage
+enum class ImageEncoding {
+    Png,        // Archivo PNG completo, listo para enviar o guardar
+    Raw         // Píxeles RGB o RGBA sin comprimir, filas de arriba a abajo
+};
+
+// Imagen renderizada en memoria
+struct RenderedImage {
+    std::vector<unsigned char> data;
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    ImageEncoding encoding = ImageEncoding::Png;
+};
+
+class SoftwareRasterizer;
+struct RasterParams;
+
+// Backend de renderizado para la salida a archivo
+enum class RenderBackend {
+    OpenGL,     // GPU mediante contexto OpenGL
+    Software    // Rasterizador por CPU, sin ventana ni contexto gráfico
+};
+
 // Clase para manejar la renderización
 class Renderer {
 public:
     Renderer();
     ~Renderer();
     
-    // Inicialización
+    // Inicialización; initialize abre una ventana con la fábrica registrada en
+    // HeadlessContext::setWindowFactory (sin ella, solo está disponible initializeHeadless)
     bool initialize(int width, int height, bool headless = false);
     bool initializeHeadless(int width, int height);
     void cleanup();
@@ -41,15 +81,92 @@ public:
     // Operaciones
     void render();
     void renderModel();
+    
+    // Dibuja la escena solo en un rectángulo de la ventana (coordenadas OpenGL, origen abajo)
+    void renderViewport(int x, int y, int width, int height);
     bool renderToFile(const std::string& filename, bool transparentBg = false);
     bool loadModel(const std::string& filename);
     bool saveImage(const std::string& filename, bool transparentBg = false);
     
+    // Render de salida a memoria (filas ya en orden de imagen) para codificar el PNG en
+    // otro hilo. Los pósters que necesitan bandas (needsTiledOutput) van por renderToFile
+    bool renderToBuffer(std::vector<unsigned char>& buffer, int& numChannels, bool transparentBg = false);
+    bool needsTiledOutput() const;
+    
+    // Render completo sin pasar por disco: aplica settings, sube el modelo, encuadra la
+    // cámara y devuelve el PNG o los píxeles. Los pósters (needsTiledOutput) no caben
+    bool renderImage(Model&& model, const RenderJobSettings& settings, RenderedImage& image,
+                     ImageEncoding encoding = ImageEncoding::Png);
+    
+    // Tamaño, muestras y colores de settings; la cámara depende del modelo (ver renderImage)
+    void applyJobSettings(const RenderJobSettings& settings);
+    
+    // PNG en memoria a partir de píxeles en orden de imagen (seguro desde cualquier hilo)
+    static bool encodePng(const unsigned char* pixels, int width, int height, int numChannels,
+                          std::vector<unsigned char>& png);
+    
+    // Todas las escrituras de salidas pasan por aquí: replaceOutputFile borra el archivo
+    // anterior, que puede ser un enlace duro a la caché de renders (escribir encima
+    // cambiaría la imagen compartida). writePng lo borra y escribe el PNG
+    static void replaceOutputFile(const std::string& filename);
+    static bool writePng(const std::string& filename, const unsigned char* pixels, int width, int height, int numChannels);
+    
+    // Renderizado en atlas: varias miniaturas en un único framebuffer con una sola lectura
+    bool beginAtlas(int tileWidth, int tileHeight, int columns, int rows, bool transparentBg = false);
+    bool renderAtlasTile(int index);
+    bool readAtlasTiles(const std::vector<int>& indices, std::vector<std::vector<unsigned char>>& images);
+    int getMaxFramebufferSize() const;
+    
+    // Vista previa interactiva dibujada en una textura; solo se vuelve a renderizar si
+    // cambian la cámara, los colores, el modelo o el tamaño. Devuelve la textura (0 si falla)
+    unsigned int renderPreview(int width, int height);
+    
     // Configuración
+    void setBackend(RenderBackend backend) { m_backend = backend; }
+    RenderBackend getBackend() const { return m_backend; }
+    
+    // Proveedor del contexto OpenGL en initializeHeadless (por defecto Auto)
+    void setHeadlessProvider(HeadlessProvider provider) { m_headlessProvider = provider; }
+    
+    // Permitir la ventana GLFW oculta como último recurso (no en hilos secundarios:
+    // GLFW solo crea ventanas desde el hilo principal)
+    void setWindowFallback(bool allow) { m_allowWindowFallback = allow; }
+    
+    // Proveedor del contexto realmente creado (Glfw cuando el contexto es el de una ventana)
+    HeadlessProvider getContextProvider() const { return m_context ? m_context->getProvider() : HeadlessProvider::Glfw; }
+    
+    // Reinicia modelo y cámara sin tocar el contexto ni los recursos GL (entre trabajos de un lote)
+    void resetScene();
+    
+    // Resolución y muestras MSAA de la salida a archivo; los framebuffers salen del pool
+    void setOutputSize(int width, int height);
+    void setOutputSamples(int samples) { m_outputSamples = samples > 1 ? samples : 1; }
+    int getOutputSamples() const { return m_outputSamples; }
+    void setFramebufferPoolCapacity(size_t maxEntries) { m_framebufferPool.setCapacity(maxEntries); }
+    
+    // Veces que se ha creado el contexto headless y tiempo total invertido
+    int getContextInitCount() const { return m_contextInitCount; }
+    double getContextInitMilliseconds() const { return m_contextInitMs; }
     void setBackgroundColor(const Color& color);
     void setModelColor(const Color& color);
     void setModel(const Model& model);
     
+    // Vista previa progresiva durante la carga: reserva el VBO para capacityTriangles y
+    // añade bloques de triángulos ya normalizados; setModel la sustituye al terminar
+    bool beginProgressiveModel(size_t capacityTriangles);
+    void appendProgressiveTriangles(const Triangle* triangles, size_t count);
+    
+    // Alternativa a setModel que reparte la subida del VBO en bloques (uno por frame)
+    // para no bloquear la interfaz; uploadModelChunk devuelve true al terminar
+    void beginModelUpload(Model&& model);
+    bool uploadModelChunk(size_t maxTriangles);
+    bool isUploadingModel() const { return m_uploadedTriangles < m_model.triangles.size(); }
+    float getUploadProgress() const;
+    
+    // Suelta la malla (copia en CPU y contenido del VBO) tras renderizarla; en lotes, para
+    // que la memoria de un archivo terminado no siga ocupada hasta el siguiente
+    void releaseModelData();
+    
     // Operaciones de cámara
     void setCameraOrbit(float yaw, float pitch, float distance);
     void setCameraPosition(const glm::vec3& position);
@@ -64,6 +181,7 @@ public:
     int getHeight() const { return m_height; }
     GLFWwindow* getWindow() const { return m_window; }
     bool hasModel() const { return m_hasModel; }
+    bool isInitialized() const { return m_initialized; }
     
 private:
     // Ventana y contexto
@@ -72,9 +190,25 @@ private:
     bool m_headless;
     bool m_initialized;
     
+    // Backend y rasterizador por CPU (solo con RenderBackend::Software)
+    RenderBackend m_backend;
+    std::unique_ptr<SoftwareRasterizer> m_softwareRasterizer;
+    
+    // Contexto OpenGL: sin ventana (EGL/OSMesa) o de una ventana GLFW, que entonces es m_window
+    HeadlessProvider m_headlessProvider;
+    std::unique_ptr<HeadlessContext> m_context;
+    bool m_allowWindowFallback;
+    
+    // Estadísticas de inicialización del contexto
+    int m_contextInitCount;
+    double m_contextInitMs;
+    
     // Modelo y renderizado
     Model m_model;
     bool m_hasModel;
+    size_t m_vertexCount;           // Vértices en el VBO (menos que el modelo durante la carga progresiva)
+    size_t m_progressiveCapacity;   // Vértices reservados para la carga progresiva (0 = inactiva)
+    size_t m_uploadedTriangles;     // Triángulos de m_model ya copiados al VBO
     
     // Shader
     std::unique_ptr<Shader> m_shader;
@@ -83,10 +217,40 @@ private:
     unsigned int m_vao, m_vbo;
     unsigned int m_defaultCubeVAO, m_defaultCubeVBO;
     
-    // Framebuffer para renderizado a imagen
-    unsigned int m_fbo;
-    unsigned int m_colorAttachment;
-    unsigned int m_depthAttachment;
+    // Framebuffers offscreen por tamaño (salida a imagen y atlas)
+    FramebufferPool m_framebufferPool;
+    PooledFramebuffer m_outputFramebuffer;
+    int m_outputSamples;
+    
+    // Vista previa en textura y estado con el que se dibujó por última vez
+    struct PreviewState {
+        glm::vec3 cameraPos = glm::vec3(0.0f);
+        glm::vec3 cameraTarget = glm::vec3(0.0f);
+        glm::vec3 modelColor = glm::vec3(-1.0f);
+        glm::vec3 backgroundColor = glm::vec3(-1.0f);
+        unsigned int modelRevision = 0;
+        int width = 0;
+        int height = 0;
+        
+        bool operator==(const PreviewState& other) const {
+            return cameraPos == other.cameraPos && cameraTarget == other.cameraTarget &&
+                   modelColor == other.modelColor && backgroundColor == other.backgroundColor &&
+                   modelRevision == other.modelRevision && width == other.width && height == other.height;
+        }
+    };
+    unsigned int m_previewFbo;
+    unsigned int m_previewTexture;
+    unsigned int m_previewDepth;
+    PreviewState m_previewState;
+    unsigned int m_modelRevision;   // Se incrementa con cada malla nueva
+    
+    // Atlas de miniaturas (framebuffer prestado por el pool; fbo = 0 sin atlas activo).
+    // Usa las muestras de la salida normal y se resuelve antes de leerlo
+    PooledFramebuffer m_atlasFramebuffer;
+    int m_atlasWidth, m_atlasHeight;
+    int m_atlasTileWidth, m_atlasTileHeight;
+    int m_atlasColumns, m_atlasRows;
+    bool m_atlasTransparent;
     
     // Colores
     Color m_backgroundColor;
@@ -105,7 +269,17 @@ private:
     void updateViewMatrix();
     void createShaders();
     void setupBuffers();
-    void setupFramebuffer();
+    void writeVertices(const Triangle* triangles, size_t count, const glm::vec3& center, float scale);
+    bool resizePreviewTarget(int width, int height);
+    void destroyPreviewTarget();
+    void recordContextInit(std::chrono::steady_clock::time_point start);
+    bool drawOutputScene();
+    bool renderOutputFrame(bool transparentBg);
+    bool readOutputPixels(std::vector<unsigned char>& buffer, bool transparentBg);
+    RasterParams makeRasterParams(bool transparentBg) const;
+    bool renderToFileTiled(const std::string& filename, bool transparentBg);
+    bool renderToFileSoftware(const std::string& filename, bool transparentBg);
+    bool writeImage(const std::string& filename, const std::vector<unsigned char>& buffer, int numChannels);
     void destroyGLResources();
     void createDefaultCube();
 }; 
\ No newline at end of file
@@ -0,0 +1,519 @@
+#include "software_rasterizer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+// Funciones de borde vectorizadas cuando el compilador garantiza SSE2
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STL_RASTER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// Tamaño de tile en píxeles (múltiplo de 4 para los bloques SIMD)
+const int kTileSize = 64;
+
+// Triángulo sin píxel ganador
+const unsigned int kNoTriangle = 0xFFFFFFFFu;
+
+// Vértice con los atributos que se interpolan durante el recorte
+struct ClipVertex {
+    glm::vec4 clip;
+    glm::vec3 world;
+    glm::vec3 normal;
+};
+
+ClipVertex lerpVertex(const ClipVertex& a, const ClipVertex& b, float t) {
+    ClipVertex v;
+    v.clip = a.clip + (b.clip - a.clip) * t;
+    v.world = a.world + (b.world - a.world) * t;
+    v.normal = a.normal + (b.normal - a.normal) * t;
+    return v;
+}
+
+// Distancia al plano cercano de OpenGL (z >= -w)
+float nearDistance(const ClipVertex& v) {
+    return v.clip.z + v.clip.w;
+}
+
+unsigned char toByte(float value) {
+    value = std::min(std::max(value, 0.0f), 1.0f);
+    return static_cast<unsigned char>(value * 255.0f + 0.5f);
+}
+
+// Hilos compartidos por todos los rasterizadores del proceso. Se crean una vez y no en
+// cada render (el lote llama una vez por archivo), y varios renderers a la vez
+// (batchRenderThreads) reparten sus tareas entre los mismos hilos en lugar de lanzar
+// cada uno uno por núcleo
+class WorkerPool {
+public:
+    static WorkerPool& instance() {
+        static WorkerPool pool;
+        return pool;
+    }
+    
+    // Ejecuta task(0) ... task(count - 1) y espera a que terminen; el hilo que llama
+    // también ejecuta tareas mientras espera
+    void run(int count, const std::function<void(int)>& task) {
+        int remaining = count;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (int i = 0; i < count; ++i) {
+            m_tasks.push_back(Task{ &task, i, &remaining });
+        }
+        lock.unlock();
+        m_wake.notify_all();
+        lock.lock();
+        
+        while (remaining > 0) {
+            if (!m_tasks.empty()) {
+                runOne(lock);
+            } else {
+                m_done.wait(lock, [&remaining]() { return remaining == 0; });
+            }
+        }
+    }
+
+private:
+    struct Task {
+        const std::function<void(int)>* function;
+        int index;
+        int* remaining;             // Tareas pendientes del run que la encoló
+    };
+    
+    WorkerPool() : m_stopping(false) {
+        unsigned int hardware = std::thread::hardware_concurrency();
+        int workers = hardware > 1 ? static_cast<int>(hardware) - 1 : 0;
+        for (int i = 0; i < workers; ++i) {
+            m_threads.emplace_back(&WorkerPool::workerLoop, this);
+        }
+    }
+    
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        for (auto& thread : m_threads) {
+            thread.join();
+        }
+    }
+    
+    // Con el mutex tomado; lo suelta mientras la tarea trabaja
+    void runOne(std::unique_lock<std::mutex>& lock) {
+        Task task = m_tasks.front();
+        m_tasks.pop_front();
+        lock.unlock();
+        (*task.function)(task.index);
+        lock.lock();
+        if (--*task.remaining == 0) {
+            m_done.notify_all();
+        }
+    }
+    
+    void workerLoop() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_wake.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+            if (m_tasks.empty()) {
+                return;
+            }
+            runOne(lock);
+        }
+    }
+    
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    std::deque<Task> m_tasks;
+    std::vector<std::thread> m_threads;
+    bool m_stopping;
+};
+
+}
+
+SoftwareRasterizer::SoftwareRasterizer()
+    : m_threadCount(0)
+{
+}
+
+void SoftwareRasterizer::setThreadCount(int threads) {
+    m_threadCount = std::max(0, threads);
+}
+
+int SoftwareRasterizer::getThreadCount() const {
+    if (m_threadCount > 0) {
+        return m_threadCount;
+    }
+    unsigned int hardware = std::thread::hardware_concurrency();
+    return hardware > 0 ? static_cast<int>(hardware) : 4;
+}
+
+bool SoftwareRasterizer::render(const Model& model, const RasterParams& params, int width, int height,
+                                int numChannels, std::vector<unsigned char>& output) {
+    if (width <= 0 || height <= 0 || (numChannels != 3 && numChannels != 4)) {
+        std::cerr << "Error: Parámetros de rasterizado inválidos" << std::endl;
+        return false;
+    }
+    
+    output.assign(static_cast<size_t>(width) * height * numChannels, 0);
+    
+    int threadCount = getThreadCount();
+    size_t triangleCount = model.triangles.size();
+    
+    // Etapa 1: transformar, recortar y preparar triángulos en paralelo (un rango contiguo por hilo)
+    std::vector<std::vector<SetupTriangle>> setup(threadCount);
+    WorkerPool& pool = WorkerPool::instance();
+    size_t chunk = (triangleCount + threadCount - 1) / threadCount;
+    pool.run(threadCount, [&](int t) {
+        size_t begin = std::min(triangleCount, t * chunk);
+        size_t end = std::min(triangleCount, begin + chunk);
+        setupTriangles(model, params, width, height, begin, end, setup[t]);
+    });
+    
+    // Etapa 2: repartir triángulos en bins por tile. Cada hilo rellena sus propios bins,
+    // así que el orden de envío se conserva al recorrerlos por hilo.
+    int tilesX = (width + kTileSize - 1) / kTileSize;
+    int tilesY = (height + kTileSize - 1) / kTileSize;
+    int tileCount = tilesX * tilesY;
+    
+    std::vector<std::vector<std::vector<unsigned int>>> bins(threadCount);
+    pool.run(threadCount, [&](int t) {
+        bins[t].resize(tileCount);
+        const auto& triangles = setup[t];
+        for (size_t i = 0; i < triangles.size(); ++i) {
+            const SetupTriangle& tri = triangles[i];
+            int tx0 = tri.minX / kTileSize;
+            int ty0 = tri.minY / kTileSize;
+            int tx1 = tri.maxX / kTileSize;
+            int ty1 = tri.maxY / kTileSize;
+            for (int ty = ty0; ty <= ty1; ++ty) {
+                for (int tx = tx0; tx <= tx1; ++tx) {
+                    bins[t][ty * tilesX + tx].push_back(static_cast<unsigned int>(i));
+                }
+            }
+        }
+    });
+    
+    // Etapa 3: rasterizar y sombrear los tiles; cada hilo toma el siguiente tile libre
+    std::atomic<int> nextTile(0);
+    pool.run(threadCount, [&](int) {
+        for (int tile = nextTile++; tile < tileCount; tile = nextTile++) {
+            int tileX = (tile % tilesX) * kTileSize;
+            int tileY = (tile / tilesX) * kTileSize;
+            int tileW = std::min(kTileSize, width - tileX);
+            int tileH = std::min(kTileSize, height - tileY);
+            rasterizeTile(setup, bins, tile, tileX, tileY, tileW, tileH,
+                          params, width, numChannels, output);
+        }
+    });
+    
+    return true;
+}
+
+void SoftwareRasterizer::setupTriangles(const Model& model, const RasterParams& params, int width, int height,
+                                        size_t begin, size_t end, std::vector<SetupTriangle>& out) const {
+    glm::mat4 viewProjection = params.projection * params.view;
+    out.reserve(end - begin);
+    
+    for (size_t i = begin; i < end; ++i) {
+        const Triangle& triangle = model.triangles[i];
+        
+        ClipVertex vertices[3];
+        int inside = 0;
+        for (int v = 0; v < 3; ++v) {
+            // Misma normalización que el VBO de Renderer::setModel
+            glm::vec3 position = (triangle.vertices[v].position - model.center) * model.scale;
+            vertices[v].world = position;
+            vertices[v].normal = triangle.vertices[v].normal;
+            vertices[v].clip = viewProjection * glm::vec4(position, 1.0f);
+            if (nearDistance(vertices[v]) >= 0.0f) {
+                inside++;
+            }
+        }
+        
+        if (inside == 0) {
+            continue;
+        }
+        
+        if (inside == 3) {
+            glm::vec4 clip[3] = { vertices[0].clip, vertices[1].clip, vertices[2].clip };
+            glm::vec3 world[3] = { vertices[0].world, vertices[1].world, vertices[2].world };
+            glm::vec3 normal[3] = { vertices[0].normal, vertices[1].normal, vertices[2].normal };
+            emitTriangle(clip, world, normal, width, height, out);
+            continue;
+        }
+        
+        // Recortar contra el plano cercano (Sutherland-Hodgman); el resto lo resuelven los tiles
+        ClipVertex polygon[4];
+        int count = 0;
+        for (int v = 0; v < 3; ++v) {
+            const ClipVertex& current = vertices[v];
+            const ClipVertex& next = vertices[(v + 1) % 3];
+            float dCurrent = nearDistance(current);
+            float dNext = nearDistance(next);
+            
+            if (dCurrent >= 0.0f) {
+                polygon[count++] = current;
+            }
+            if ((dCurrent >= 0.0f) != (dNext >= 0.0f)) {
+                polygon[count++] = lerpVertex(current, next, dCurrent / (dCurrent - dNext));
+            }
+        }
+        
+        for (int v = 1; v + 1 < count; ++v) {
+            glm::vec4 clip[3] = { polygon[0].clip, polygon[v].clip, polygon[v + 1].clip };
+            glm::vec3 world[3] = { polygon[0].world, polygon[v].world, polygon[v + 1].world };
+            glm::vec3 normal[3] = { polygon[0].normal, polygon[v].normal, polygon[v + 1].normal };
+            emitTriangle(clip, world, normal, width, height, out);
+        }
+    }
+}
+
+void SoftwareRasterizer::emitTriangle(const glm::vec4 clip[3], const glm::vec3 world[3], const glm::vec3 normal[3],
+                                      int width, int height, std::vector<SetupTriangle>& out) const {
+    SetupTriangle tri;
+    
+    for (int v = 0; v < 3; ++v) {
+        float w = clip[v].w;
+        if (w <= 0.0f) {
+            return;
+        }
+        float invW = 1.0f / w;
+        tri.x[v] = (clip[v].x * invW * 0.5f + 0.5f) * width;
+        tri.y[v] = (0.5f - clip[v].y * invW * 0.5f) * height;   // Origen arriba, como la imagen final
+        tri.z[v] = clip[v].z * invW;
+        tri.invW[v] = invW;
+        tri.worldPos[v] = world[v];
+        tri.normal[v] = normal[v];
+    }
+    
+    // Área con signo; sin culling (igual que la ruta OpenGL), se normaliza el orden a positivo
+    float area = (tri.x[1] - tri.x[0]) * (tri.y[2] - tri.y[0]) - (tri.x[2] - tri.x[0]) * (tri.y[1] - tri.y[0]);
+    if (std::fabs(area) < 1e-12f) {
+        return;
+    }
+    if (area < 0.0f) {
+        std::swap(tri.x[1], tri.x[2]);
+        std::swap(tri.y[1], tri.y[2]);
+        std::swap(tri.z[1], tri.z[2]);
+        std::swap(tri.invW[1], tri.invW[2]);
+        std::swap(tri.worldPos[1], tri.worldPos[2]);
+        std::swap(tri.normal[1], tri.normal[2]);
+        area = -area;
+    }
+    tri.invArea = 1.0f / area;
+    
+    // Caja envolvente recortada a la imagen
+    float minX = std::min(std::min(tri.x[0], tri.x[1]), tri.x[2]);
+    float maxX = std::max(std::max(tri.x[0], tri.x[1]), tri.x[2]);
+    float minY = std::min(std::min(tri.y[0], tri.y[1]), tri.y[2]);
+    float maxY = std::max(std::max(tri.y[0], tri.y[1]), tri.y[2]);
+    
+    if (maxX < 0.0f || maxY < 0.0f || minX >= width || minY >= height) {
+        return;
+    }
+    
+    tri.minX = std::max(0, static_cast<int>(std::floor(minX)));
+    tri.minY = std::max(0, static_cast<int>(std::floor(minY)));
+    tri.maxX = std::min(width - 1, static_cast<int>(std::ceil(maxX)));
+    tri.maxY = std::min(height - 1, static_cast<int>(std::ceil(maxY)));
+    
+    out.push_back(tri);
+}
+
+void SoftwareRasterizer::rasterizeTile(const std::vector<std::vector<SetupTriangle>>& triangles,
+                                       const std::vector<std::vector<std::vector<unsigned int>>>& bins,
+                                       int tileIndex, int tileX, int tileY, int tileW, int tileH,
+                                       const RasterParams& params, int width, int numChannels,
+                                       std::vector<unsigned char>& output) const {
+    // Buffer de visibilidad del tile: profundidad, triángulo ganador y sus pesos baricéntricos
+    float depth[kTileSize * kTileSize];
+    unsigned int triangleId[kTileSize * kTileSize];
+    unsigned int binId[kTileSize * kTileSize];
+    float weight1[kTileSize * kTileSize];
+    float weight2[kTileSize * kTileSize];
+    
+    std::fill(depth, depth + kTileSize * kTileSize, 1.0f);
+    std::fill(triangleId, triangleId + kTileSize * kTileSize, kNoTriangle);
+    
+    for (size_t b = 0; b < bins.size(); ++b) {
+        const std::vector<unsigned int>& bin = bins[b][tileIndex];
+        const std::vector<SetupTriangle>& source = triangles[b];
+        
+        for (unsigned int index : bin) {
+            const SetupTriangle& tri = source[index];
+            
+            int x0 = std::max(tri.minX, tileX);
+            int y0 = std::max(tri.minY, tileY);
+            int x1 = std::min(tri.maxX, tileX + tileW - 1);
+            int y1 = std::min(tri.maxY, tileY + tileH - 1);
+            if (x0 > x1 || y0 > y1) {
+                continue;
+            }
+            
+            // Funciones de borde E(x, y) = A*x + B*y + C evaluadas en el centro del píxel
+            float a0 = tri.y[1] - tri.y[2], b0 = tri.x[2] - tri.x[1];
+            float a1 = tri.y[2] - tri.y[0], b1 = tri.x[0] - tri.x[2];
+            float a2 = tri.y[0] - tri.y[1], b2 = tri.x[1] - tri.x[0];
+            float c0 = tri.x[1] * tri.y[2] - tri.x[2] * tri.y[1];
+            float c1 = tri.x[2] * tri.y[0] - tri.x[0] * tri.y[2];
+            float c2 = tri.x[0] * tri.y[1] - tri.x[1] * tri.y[0];
+            
+            // Profundidad lineal en pantalla: z = z0 + dz1 * w1 + dz2 * w2
+            float z0 = tri.z[0];
+            float dz1 = tri.z[1] - tri.z[0];
+            float dz2 = tri.z[2] - tri.z[0];
+            
+            // Alinear el inicio de fila a 4 píxeles dentro del tile para los bloques SIMD
+            int xStart = tileX + ((x0 - tileX) & ~3);
+            
+            for (int y = y0; y <= y1; ++y) {
+                float py = y + 0.5f;
+                int row = (y - tileY) * kTileSize;
+
+#if STL_RASTER_SSE2
+                const __m128 offsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+                const __m128 zero = _mm_setzero_ps();
+                const __m128 vA0 = _mm_set1_ps(a0), vA1 = _mm_set1_ps(a1), vA2 = _mm_set1_ps(a2);
+                const __m128 vInvArea = _mm_set1_ps(tri.invArea);
+                const __m128 vZ0 = _mm_set1_ps(z0), vDz1 = _mm_set1_ps(dz1), vDz2 = _mm_set1_ps(dz2);
+                const __m128 rowE0 = _mm_set1_ps(b0 * py + c0);
+                const __m128 rowE1 = _mm_set1_ps(b1 * py + c1);
+                const __m128 rowE2 = _mm_set1_ps(b2 * py + c2);
+                
+                for (int x = xStart; x <= x1; x += 4) {
+                    __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offsets);
+                    __m128 e0 = _mm_add_ps(_mm_mul_ps(vA0, px), rowE0);
+                    __m128 e1 = _mm_add_ps(_mm_mul_ps(vA1, px), rowE1);
+                    __m128 e2 = _mm_add_ps(_mm_mul_ps(vA2, px), rowE2);
+                    
+                    __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)),
+                                               _mm_cmpge_ps(e2, zero));
+                    int mask = _mm_movemask_ps(inside);
+                    if (mask == 0) {
+                        continue;
+                    }
+                    
+                    __m128 w1 = _mm_mul_ps(e1, vInvArea);
+                    __m128 w2 = _mm_mul_ps(e2, vInvArea);
+                    __m128 z = _mm_add_ps(vZ0, _mm_add_ps(_mm_mul_ps(vDz1, w1), _mm_mul_ps(vDz2, w2)));
+                    
+                    alignas(16) float zs[4], w1s[4], w2s[4];
+                    _mm_store_ps(zs, z);
+                    _mm_store_ps(w1s, w1);
+                    _mm_store_ps(w2s, w2);
+                    
+                    for (int lane = 0; lane < 4; ++lane) {
+                        int px0 = x + lane;
+                        if (!(mask & (1 << lane)) || px0 < x0 || px0 > x1) {
+                            continue;
+                        }
+                        int pixel = row + (px0 - tileX);
+                        // Prueba de profundidad GL_LESS dentro del rango [-1, 1]
+                        if (zs[lane] >= -1.0f && zs[lane] < depth[pixel]) {
+                            depth[pixel] = zs[lane];
+                            triangleId[pixel] = index;
+                            binId[pixel] = static_cast<unsigned int>(b);
+                            weight1[pixel] = w1s[lane];
+                            weight2[pixel] = w2s[lane];
+                        }
+                    }
+                }
+#else
+                for (int x = x0; x <= x1; ++x) {
+                    float px = x + 0.5f;
+                    float e0 = a0 * px + b0 * py + c0;
+                    float e1 = a1 * px + b1 * py + c1;
+                    float e2 = a2 * px + b2 * py + c2;
+                    if (e0 < 0.0f || e1 < 0.0f || e2 < 0.0f) {
+                        continue;
+                    }
+                    
+                    float w1 = e1 * tri.invArea;
+                    float w2 = e2 * tri.invArea;
+                    float z = z0 + dz1 * w1 + dz2 * w2;
+                    int pixel = row + (x - tileX);
+                    if (z >= -1.0f && z < depth[pixel]) {
+                        depth[pixel] = z;
+                        triangleId[pixel] = index;
+                        binId[pixel] = static_cast<unsigned int>(b);
+                        weight1[pixel] = w1;
+                        weight2[pixel] = w2;
+                    }
+                }
+#endif
+            }
+        }
+    }
+    
+    // Sombreado diferido: una sola evaluación de Phong por píxel visible
+    glm::vec3 background = params.backgroundColor;
+    unsigned char backgroundAlpha = params.transparentBackground ? 0 : 255;
+    
+    for (int y = 0; y < tileH; ++y) {
+        unsigned char* dst = output.data() + (static_cast<size_t>(tileY + y) * width + tileX) * numChannels;
+        
+        for (int x = 0; x < tileW; ++x, dst += numChannels) {
+            int pixel = y * kTileSize + x;
+            
+            if (triangleId[pixel] == kNoTriangle) {
+                if (params.transparentBackground) {
+                    dst[0] = dst[1] = dst[2] = 0;
+                } else {
+                    dst[0] = toByte(background.x);
+                    dst[1] = toByte(background.y);
+                    dst[2] = toByte(background.z);
+                }
+                if (numChannels == 4) {
+                    dst[3] = backgroundAlpha;
+                }
+                continue;
+            }
+            
+            const SetupTriangle& tri = triangles[binId[pixel]][triangleId[pixel]];
+            
+            // Baricéntricas con corrección de perspectiva
+            float w1 = weight1[pixel];
+            float w2 = weight2[pixel];
+            float w0 = 1.0f - w1 - w2;
+            float p0 = w0 * tri.invW[0];
+            float p1 = w1 * tri.invW[1];
+            float p2 = w2 * tri.invW[2];
+            float invSum = 1.0f / (p0 + p1 + p2);
+            p0 *= invSum;
+            p1 *= invSum;
+            p2 *= invSum;
+            
+            glm::vec3 fragPos = tri.worldPos[0] * p0 + tri.worldPos[1] * p1 + tri.worldPos[2] * p2;
+            glm::vec3 normal = tri.normal[0] * p0 + tri.normal[1] * p1 + tri.normal[2] * p2;
+            
+            // Mismo modelo de iluminación que fragmentShaderSource
+            glm::vec3 norm = glm::normalize(normal);
+            glm::vec3 lightDir = glm::normalize(params.lightPos - fragPos);
+            float diff = std::max(glm::dot(norm, lightDir), 0.0f);
+            
+            glm::vec3 viewDir = glm::normalize(params.cameraPos - fragPos);
+            glm::vec3 reflectDir = glm::reflect(-lightDir, norm);
+            float spec = std::pow(std::max(glm::dot(viewDir, reflectDir), 0.0f), 32.0f);
+            
+            float light = 0.3f + diff + 0.5f * spec;
+            glm::vec3 result = params.objectColor * light;
+            
+            dst[0] = toByte(result.x);
+            dst[1] = toByte(result.y);
+            dst[2] = toByte(result.z);
+            if (numChannels == 4) {
+                dst[3] = 255;
+            }
+        }
+    }
+}
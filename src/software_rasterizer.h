@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "model.h"
+
+// Parámetros de una pasada de rasterizado por CPU
+struct RasterParams {
+    glm::mat4 view = glm::mat4(1.0f);
+    glm::mat4 projection = glm::mat4(1.0f);
+    glm::vec3 cameraPos = glm::vec3(0.0f);
+    glm::vec3 lightPos = glm::vec3(0.0f);
+    glm::vec3 objectColor = glm::vec3(0.7f);
+    glm::vec3 backgroundColor = glm::vec3(0.0f);
+    bool transparentBackground = false;
+};
+
+// Rasterizador por software para mallas opacas de un solo material.
+// Divide la imagen en tiles, reparte los triángulos en bins por tile y
+// procesa los tiles en paralelo evaluando las funciones de borde de 4 en 4
+// píxeles (SSE2 cuando está disponible). Reproduce el sombreado Phong de
+// fragmentShaderSource para que la salida coincida con la ruta OpenGL.
+class SoftwareRasterizer {
+public:
+    SoftwareRasterizer();
+    
+    // Partes en que se reparte cada etapa (0 = una por núcleo). Las ejecuta un conjunto de
+    // hilos compartido por todo el proceso, creado con el primer render
+    void setThreadCount(int threads);
+    int getThreadCount() const;
+    
+    // Rasteriza el modelo (posiciones normalizadas con center/scale como en Renderer::setModel)
+    // y escribe la imagen de arriba a abajo en output con 3 (RGB) o 4 (RGBA) canales
+    bool render(const Model& model, const RasterParams& params, int width, int height,
+                int numChannels, std::vector<unsigned char>& output);
+
+private:
+    // Triángulo ya proyectado a pantalla y listo para rasterizar
+    struct SetupTriangle {
+        float x[3], y[3];       // Posición en pantalla (píxeles, origen arriba a la izquierda)
+        float z[3];             // Profundidad NDC (lineal en pantalla)
+        float invW[3];          // 1/w para interpolación con corrección de perspectiva
+        glm::vec3 worldPos[3];
+        glm::vec3 normal[3];
+        float invArea;
+        int minX, minY, maxX, maxY;
+    };
+    
+    int m_threadCount;
+    
+    // Etapas
+    void setupTriangles(const Model& model, const RasterParams& params, int width, int height,
+                        size_t begin, size_t end, std::vector<SetupTriangle>& out) const;
+    void emitTriangle(const glm::vec4 clip[3], const glm::vec3 world[3], const glm::vec3 normal[3],
+                      int width, int height, std::vector<SetupTriangle>& out) const;
+    void rasterizeTile(const std::vector<std::vector<SetupTriangle>>& triangles,
+                       const std::vector<std::vector<std::vector<unsigned int>>>& bins,
+                       int tileIndex, int tileX, int tileY, int tileW, int tileH,
+                       const RasterParams& params, int width, int numChannels,
+                       std::vector<unsigned char>& output) const;
+};
@@ -8,7 +8,33 @@
 #include <cstring>
 #include <limits>
 
-StlLoader::StlLoader() {
+namespace {
+
+// Tamaños a partir de los que merece la pena la vista previa progresiva
+const uint32_t kProgressiveMinTriangles = 200000;
+const std::streamoff kProgressiveMinAsciiBytes = 32 * 1024 * 1024;
+
+// Triángulos de la muestra inicial repartida por el archivo binario
+const uint32_t kCoarseTriangles = 50000;
+
+// Cada cuántos triángulos se comprueba si toca refrescar la vista previa, e intervalo mínimo
+const size_t kPreviewCheckInterval = 16384;
+const auto kPreviewInterval = std::chrono::milliseconds(100);
+
+// Bytes por faceta en STL ASCII para estimar la capacidad del VBO (las facetas reales ocupan más)
+const std::streamoff kAsciiBytesPerFacet = 200;
+
+// Registro de triángulo en STL binario: normal, 3 vértices y 2 bytes de atributo
+const std::streamoff kBinaryTriangleSize = 50;
+
+} // namespace
+
+StlLoader::StlLoader()
+    : m_previewActive(false)
+    , m_previewCenter(0.0f)
+    , m_previewScale(1.0f)
+    , m_previewSent(0)
+{
     // Inicializar modelo vacío
     m_model.minBounds = glm::vec3(std::numeric_limits<float>::max());
     m_model.maxBounds = glm::vec3(std::numeric_limits<float>::lowest());
@@ -22,6 +48,48 @@ StlLoader::~StlLoader() {
 }
 
 bool StlLoader::loadModel(const std::string& filename, Renderer& renderer) {
+    if (!loadFile(filename)) {
+        return false;
+    }
+    
+    // Enviar modelo al renderer
+    renderer.setModel(m_model);
+    return true;
+}
+
+uint64_t StlLoader::estimateTriangles(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return 0;
+    }
+    
+    file.seekg(0, std::ios::end);
+    std::streamoff fileSize = file.tellg();
+    if (fileSize < 84) {
+        return 0;
+    }
+    
+    char header[84];
+    file.seekg(0, std::ios::beg);
+    if (!file.read(header, sizeof(header))) {
+        return 0;
+    }
+    
+    uint32_t numTriangles = 0;
+    std::memcpy(&numTriangles, header + 80, sizeof(numTriangles));
+    std::streamoff records = (fileSize - 84) / kBinaryTriangleSize;
+    
+    // Hay binarios que también empiezan por "solid": manda que el tamaño cuadre con el contador
+    if (84 + static_cast<std::streamoff>(numTriangles) * kBinaryTriangleSize == fileSize) {
+        return numTriangles;
+    }
+    if (std::strncmp(header, "solid", 5) == 0) {
+        return static_cast<uint64_t>(fileSize / kAsciiBytesPerFacet);
+    }
+    return static_cast<uint64_t>(std::min<std::streamoff>(numTriangles, records));
+}
+
+bool StlLoader::loadFile(const std::string& filename) {
     // Limpiar modelo anterior
     m_model.triangles.clear();
     
@@ -54,6 +122,7 @@ bool StlLoader::loadModel(const std::string& filename, Renderer& renderer) {
     file.close();
     
     bool success = false;
+    m_previewActive = false;
     
     // Comprobar si es ASCII (comienza con "solid")
     if (std::strncmp(header, "solid", 5) == 0) {
@@ -64,6 +133,9 @@ bool StlLoader::loadModel(const std::string& filename, Renderer& renderer) {
         success = loadBinarySTL(filename);
     }
     
+    // La malla definitiva sustituye a la vista previa en setModel
+    m_previewActive = false;
+    
     if (success) {
         // Calcular información del modelo
         calculateModelInfo();
@@ -85,19 +157,11 @@ bool StlLoader::loadModel(const std::string& filename, Renderer& renderer) {
         // Aplicar rotación a todos los vértices para una correcta orientación de miniaturas
         for (auto& triangle : m_model.triangles) {
             for (int i = 0; i < 3; ++i) {
-                // Almacenar coordenadas originales
-                float originalY = triangle.vertices[i].position.y;
-                float originalZ = triangle.vertices[i].position.z;
-                
                 // Intercambiar Y y Z con la orientación correcta para miniaturas e invertir Z
-                triangle.vertices[i].position.y = originalZ;
-                triangle.vertices[i].position.z = -originalY; // Negamos Y original para invertir Z
+                triangle.vertices[i].position = toZUp(triangle.vertices[i].position);
                 
                 // También ajustar las normales
-                originalY = triangle.vertices[i].normal.y;
-                originalZ = triangle.vertices[i].normal.z;
-                triangle.vertices[i].normal.y = originalZ;
-                triangle.vertices[i].normal.z = -originalY; // Invertimos también la normal
+                triangle.vertices[i].normal = toZUp(triangle.vertices[i].normal);
             }
         }
         
@@ -150,11 +214,11 @@ bool StlLoader::loadModel(const std::string& filename, Renderer& renderer) {
                     << firstTri.vertices[0].normal.y << ", " 
                     << firstTri.vertices[0].normal.z << ")\n";
         }
-        
-        // Enviar modelo al renderer
-        renderer.setModel(m_model);
     } else {
         std::cerr << "Error al cargar el modelo" << std::endl;
+        
+        // Liberar lo leído antes de una cancelación o un error
+        std::vector<Triangle>().swap(m_model.triangles);
     }
     
     return success;
@@ -179,6 +243,17 @@ bool StlLoader::loadBinarySTL(const std::string& filename) {
     // Reservar espacio para todos los triángulos
     m_model.triangles.reserve(numTriangles);
     
+    // Archivos grandes: muestra repartida por todo el archivo para tener algo que mostrar ya
+    if (m_progress.onTriangles && numTriangles >= kProgressiveMinTriangles) {
+        std::vector<Triangle> sample;
+        loadCoarseSample(file, numTriangles, sample);
+        if (!sample.empty()) {
+            startPreview(sample, sample.size() + numTriangles);
+        }
+        file.clear();
+        file.seekg(84);
+    }
+    
     // Leer cada triángulo
     for (uint32_t i = 0; i < numTriangles; ++i) {
         Triangle tri;
@@ -201,6 +276,17 @@ bool StlLoader::loadBinarySTL(const std::string& filename) {
         
         // Agregar triángulo al modelo
         m_model.triangles.push_back(tri);
+        
+        if ((i + 1) % kPreviewCheckInterval == 0) {
+            if (!reportProgress(84 + (uint64_t)(i + 1) * kBinaryTriangleSize, 84 + (uint64_t)numTriangles * kBinaryTriangleSize)) {
+                return false;
+            }
+            
+            // Refinar la vista previa con los triángulos leídos desde el último aviso
+            if (m_previewActive) {
+                emitPreview((float)(i + 1) / numTriangles);
+            }
+        }
     }
     
     file.close();
@@ -215,6 +301,12 @@ bool StlLoader::loadAsciiSTL(const std::string& filename) {
         return false;
     }
     
+    // En ASCII no hay acceso aleatorio: la vista previa empieza con el primer bloque leído
+    file.seekg(0, std::ios::end);
+    std::streamoff fileSize = file.tellg();
+    file.seekg(0, std::ios::beg);
+    bool progressive = m_progress.onTriangles && fileSize >= kProgressiveMinAsciiBytes;
+    
     std::string line;
     glm::vec3 normal;
     int vertexIndex = 0;
@@ -246,6 +338,19 @@ bool StlLoader::loadAsciiSTL(const std::string& filename) {
             if (vertexIndex == 3) {
                 m_model.triangles.push_back(currentTriangle);
                 vertexIndex = 0;
+                
+                if (m_model.triangles.size() % kPreviewCheckInterval == 0 && !reportProgress((uint64_t)file.tellg(), (uint64_t)fileSize)) {
+                    return false;
+                }
+                
+                if (progressive && m_model.triangles.size() % kPreviewCheckInterval == 0) {
+                    if (!m_previewActive) {
+                        startPreview(m_model.triangles, (size_t)(fileSize / kAsciiBytesPerFacet));
+                        m_previewSent = m_model.triangles.size();
+                    } else {
+                        emitPreview((float)file.tellg() / fileSize);
+                    }
+                }
             }
         }
     }
@@ -296,4 +401,99 @@ void StlLoader::calculateModelInfo() {
     
     std::cout << "Centro del modelo: (" << m_model.center.x << ", " << m_model.center.y << ", " << m_model.center.z << ")\n";
     std::cout << "Factor de escala: " << m_model.scale << "\n";
-} 
\ No newline at end of file
+} 
+
+void StlLoader::loadCoarseSample(std::ifstream& file, uint32_t numTriangles, std::vector<Triangle>& sample) {
+    uint32_t stride = std::max(numTriangles / kCoarseTriangles, 1u);
+    sample.reserve(numTriangles / stride + 1);
+    
+    float data[12];
+    for (uint32_t i = 0; i < numTriangles; i += stride) {
+        file.seekg(84 + (std::streamoff)i * kBinaryTriangleSize);
+        if (!file.read(reinterpret_cast<char*>(data), sizeof(data))) {
+            break;
+        }
+        
+        Triangle tri;
+        glm::vec3 normal(data[0], data[1], data[2]);
+        for (int j = 0; j < 3; ++j) {
+            tri.vertices[j].position = glm::vec3(data[3 + j * 3], data[4 + j * 3], data[5 + j * 3]);
+            tri.vertices[j].normal = normal;
+        }
+        sample.push_back(tri);
+    }
+    
+    std::cout << "Muestra inicial para la vista previa: " << sample.size() << " triángulos (1 de cada " << stride << ")\n";
+}
+
+void StlLoader::startPreview(const std::vector<Triangle>& sample, size_t capacityTriangles) {
+    // Centro y escala estimados con la muestra, como hará calculateModelInfo con el modelo completo
+    glm::vec3 minBounds(std::numeric_limits<float>::max());
+    glm::vec3 maxBounds(std::numeric_limits<float>::lowest());
+    for (const auto& triangle : sample) {
+        for (int i = 0; i < 3; ++i) {
+            minBounds = glm::min(minBounds, triangle.vertices[i].position);
+            maxBounds = glm::max(maxBounds, triangle.vertices[i].position);
+        }
+    }
+    
+    glm::vec3 dimensions = maxBounds - minBounds;
+    float maxDimension = std::max(std::max(dimensions.x, dimensions.y), dimensions.z);
+    m_previewCenter = (minBounds + maxBounds) * 0.5f;
+    m_previewScale = maxDimension > 0.0f ? 1.0f / maxDimension : 1.0f;
+    
+    if (m_progress.onBegin) {
+        m_progress.onBegin(capacityTriangles);
+    }
+    
+    std::vector<Triangle> chunk;
+    chunk.reserve(sample.size());
+    for (const auto& triangle : sample) {
+        chunk.push_back(toPreviewSpace(triangle));
+    }
+    m_progress.onTriangles(chunk, 0.0f);
+    
+    m_previewActive = true;
+    m_previewSent = 0;
+    m_lastPreview = std::chrono::steady_clock::now();
+}
+
+void StlLoader::emitPreview(float progress) {
+    auto now = std::chrono::steady_clock::now();
+    if (now - m_lastPreview < kPreviewInterval) {
+        return;
+    }
+    
+    std::vector<Triangle> chunk;
+    chunk.reserve(m_model.triangles.size() - m_previewSent);
+    for (size_t i = m_previewSent; i < m_model.triangles.size(); ++i) {
+        chunk.push_back(toPreviewSpace(m_model.triangles[i]));
+    }
+    m_previewSent = m_model.triangles.size();
+    
+    m_progress.onTriangles(chunk, progress);
+    m_lastPreview = std::chrono::steady_clock::now();
+}
+
+bool StlLoader::reportProgress(uint64_t bytesRead, uint64_t totalBytes) {
+    if (m_progress.onRead) {
+        m_progress.onRead(bytesRead, totalBytes, m_model.triangles.size());
+    }
+    
+    if (m_progress.isCancelled && m_progress.isCancelled()) {
+        std::cout << "Carga cancelada tras " << m_model.triangles.size() << " triángulos\n";
+        return false;
+    }
+    
+    return true;
+}
+
+Triangle StlLoader::toPreviewSpace(const Triangle& triangle) const {
+    // Misma transformación que loadModel + setModel: centrar, orientar Z arriba y escalar
+    Triangle result;
+    for (int i = 0; i < 3; ++i) {
+        result.vertices[i].position = toZUp(triangle.vertices[i].position - m_previewCenter) * m_previewScale;
+        result.vertices[i].normal = toZUp(triangle.vertices[i].normal);
+    }
+    return result;
+}
\ No newline at end of file
@@ -2,11 +2,30 @@
 
 #include <string>
 #include <vector>
+#include <fstream>
+#include <functional>
+#include <cstdint>
+#include <chrono>
 #include <glm/glm.hpp>
 #include "model.h"
 
 class Renderer;
 
+// Avisos durante la carga. Para la vista previa progresiva de archivos grandes, los
+// triángulos llegan ya orientados (Z arriba) y normalizados con un centro y una escala
+// estimados a partir de una muestra del archivo; la malla exacta llega al terminar.
+// Todos se llaman desde el hilo que carga, que puede no tener contexto OpenGL
+struct StlLoadProgress {
+    std::function<void(size_t capacityTriangles)> onBegin;
+    std::function<void(const std::vector<Triangle>& triangles, float progress)> onTriangles;
+    
+    // Bytes y triángulos leídos hasta ahora
+    std::function<void(uint64_t bytesRead, uint64_t totalBytes, size_t triangles)> onRead;
+    
+    // Si devuelve true la carga se interrumpe y loadFile falla
+    std::function<bool()> isCancelled;
+};
+
 class StlLoader {
 public:
     StlLoader();
@@ -15,8 +34,25 @@ public:
     // Cargar un modelo STL desde archivo y enviarlo al renderer
     bool loadModel(const std::string& filename, Renderer& renderer);
     
+    // Cargar, centrar y orientar el modelo sin tocar el renderer (válido fuera del hilo de OpenGL)
+    bool loadFile(const std::string& filename);
+    
+    // Entrega el modelo cargado sin copiarlo (el cargador queda vacío)
+    Model releaseModel() { return std::move(m_model); }
+    
     // Obtener información del modelo cargado
     const Model& getModel() const { return m_model; }
+    
+    // Vista previa progresiva (solo se activa con archivos grandes)
+    void setProgressHandler(const StlLoadProgress& handler) { m_progress = handler; }
+    void clearProgressHandler() { m_progress = StlLoadProgress(); }
+    
+    // Orientación Z arriba de las miniaturas: intercambia Y y Z e invierte la nueva Z
+    static glm::vec3 toZUp(const glm::vec3& v) { return glm::vec3(v.x, v.z, -v.y); }
+    
+    // Triángulos estimados sin cargar el modelo: el contador de la cabecera binaria o, en
+    // ASCII, según el tamaño del archivo. Coste para ordenar lotes; 0 si no se puede leer
+    static uint64_t estimateTriangles(const std::string& filename);
 
 private:
     Model m_model;
@@ -27,4 +63,18 @@ private:
     
     // Calcular información del modelo después de cargarlo
     void calculateModelInfo();
+    
+    // Vista previa progresiva
+    StlLoadProgress m_progress;
+    bool m_previewActive;
+    glm::vec3 m_previewCenter;
+    float m_previewScale;
+    size_t m_previewSent;           // Triángulos de m_model ya enviados a la vista previa
+    std::chrono::steady_clock::time_point m_lastPreview;
+    
+    void loadCoarseSample(std::ifstream& file, uint32_t numTriangles, std::vector<Triangle>& sample);
+    void startPreview(const std::vector<Triangle>& sample, size_t capacityTriangles);
+    void emitPreview(float progress);
+    bool reportProgress(uint64_t bytesRead, uint64_t totalBytes);
+    Triangle toPreviewSpace(const Triangle& triangle) const;
 }; 
\ No newline at end of file